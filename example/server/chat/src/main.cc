@@ -307,11 +307,11 @@ int main(int argc, char *argv[])
     ctx.channels.at("/").broadcast("0" + std::to_string(ctx.channels.size()));
     // send user count
     ctx.channels.at("/").broadcast("1" + std::to_string(user_count));
-    for (auto const& e : ctx.channels)
+    ctx.channels.for_each([&](auto const& name, auto const& channel)
     {
       // send count and room info
-      ctx.channels.at("/").broadcast("2" + std::to_string(e.second.size()) + e.first);
-    }
+      ctx.channels.at("/").broadcast("2" + std::to_string(channel.size()) + name);
+    });
   });
 
   // set websocket disconnect callback
@@ -325,11 +325,11 @@ int main(int argc, char *argv[])
     ctx.channels.at("/").broadcast("0" + std::to_string(ctx.channels.size()));
     // send user count
     ctx.channels.at("/").broadcast("1" + std::to_string(user_count));
-    for (auto const& e : ctx.channels)
+    ctx.channels.for_each([&](auto const& name, auto const& channel)
     {
       // send count and room info
-      ctx.channels.at("/").broadcast("2" + std::to_string(e.second.size()) + e.first);
-    }
+      ctx.channels.at("/").broadcast("2" + std::to_string(channel.size()) + name);
+    });
   });
 
   // handle route GET '/'
@@ -23,15 +23,22 @@ std::string http_routes(Belle::Server::Http_Routes& routes)
   {
     res << "Route:  " << (*e).first << "\nMethod:";
 
-    for (auto const& m : (*e).second)
+    auto const& fns = (*e).second.fns;
+
+    for (std::size_t m = 0; m < fns.size(); ++m)
     {
-      if (static_cast<Belle::Method>(m.first) == Belle::Method::unknown)
+      if (! fns[m])
+      {
+        continue;
+      }
+
+      if (static_cast<Belle::Method>(m) == Belle::Method::unknown)
       {
         res << " ALL";
       }
       else
       {
-        res << " " << Belle::http::to_string(static_cast<Belle::Method>(m.first));
+        res << " " << Belle::http::to_string(static_cast<Belle::Method>(m));
       }
     }
 
@@ -58,9 +65,7 @@ int main(int argc, char *argv[])
   // default value is 1 single thread
   app.threads(std::thread::hardware_concurrency());
 
-  // multithreading can be enabled on an http only server
-  // websocket upgrades must be disabled to use multithreading
-  // the websocket channel implementation is not thread safe
+  // disable websocket upgrades
   // default value is true
   app.websocket(false);
 
@@ -100,6 +105,7 @@ int main(int argc, char *argv[])
       <a href="/method">methods</a><br>
       <a href="/params?key=value&blank=&query=test&page=2">query parameters</a><br>
       <a href="/regex/hello">regex route</a><br>
+      <a href="/fixed">fixed route</a><br>
       <a href="/error">custom error</a><br>
       <a href="/index.html">static page</a><br>
     )"};
@@ -165,6 +171,8 @@ int main(int argc, char *argv[])
     res << "Query Parameters\n";
 
     // access the query parameters
+    // they are parsed from the target on first access
+    // use ctx.req.param("key") to find a single value without parsing them all
     for (auto const& [key, val] : ctx.req.params())
     {
       // add each key value pair to the response
@@ -193,6 +201,8 @@ int main(int argc, char *argv[])
     // index 0 contains the matched path, minus any query parameters
     // index 1 to n contain the value of the capture groups if any
     // the full path with query parameters is in req.target()
+    // req.path_view() holds the same values as string views
+    // into the target, without copying them
     std::string path {ctx.req.path().at(0)};
     std::string match {ctx.req.path().at(1)};
 
@@ -212,6 +222,33 @@ int main(int argc, char *argv[])
     ctx.res.body() = res.str();
   });
 
+  // handle routes from a compile time route table
+  // the literal paths are hashed at compile time and
+  // the handlers are called directly without type erasure
+  // the table is checked before the other routes
+  app.on_http(Belle::Server::route_table(
+    Belle::Server::fixed_route("/fixed", Belle::Method::get,
+      [](Belle::Server::Http_Ctx& ctx)
+      {
+        // set http response headers
+        ctx.res.set("content-type", "text/plain");
+
+        // set the http body
+        ctx.res.body() = "Fixed Route\n";
+      }
+    ),
+    Belle::Server::fixed_route("/fixed/all",
+      [](Belle::Server::Http_Ctx& ctx)
+      {
+        // set http response headers
+        ctx.res.set("content-type", "text/plain");
+
+        // echo back the matched http method
+        ctx.res.body() = "Fixed Route\nmethod: " + ctx.req.method_string().to_string() + "\n";
+      }
+    )
+  ));
+
   // trigger the custom error callback
   app.on_http("/error", Belle::Method::get, [](Belle::Server::Http_Ctx& ctx)
   {
@@ -23,15 +23,22 @@ std::string http_routes(Belle::Server::Http_Routes& routes)
   {
     res << "Route:  " << (*e).first << "\nMethod:";
 
-    for (auto const& m : (*e).second)
+    auto const& fns = (*e).second.fns;
+
+    for (std::size_t m = 0; m < fns.size(); ++m)
     {
-      if (static_cast<Belle::Method>(m.first) == Belle::Method::unknown)
+      if (! fns[m])
+      {
+        continue;
+      }
+
+      if (static_cast<Belle::Method>(m) == Belle::Method::unknown)
       {
         res << " ALL";
       }
       else
       {
-        res << " " << Belle::http::to_string(static_cast<Belle::Method>(m.first));
+        res << " " << Belle::http::to_string(static_cast<Belle::Method>(m));
       }
     }
 
@@ -93,9 +100,7 @@ int main(int argc, char *argv[])
   // default value is 1 single thread
   app.threads(std::thread::hardware_concurrency());
 
-  // multithreading can be enabled on an http only server
-  // websocket upgrades must be disabled to use multithreading
-  // the websocket channel implementation is not thread safe
+  // disable websocket upgrades
   // default value is true
   app.websocket(false);
 
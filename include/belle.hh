@@ -90,6 +90,9 @@ SOFTWARE.
 #include <boost/asio/signal_set.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/bind_executor.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/thread_pool.hpp>
 
 #ifdef OB_BELLE_CONFIG_CLIENT_ON
 #include <boost/asio/connect.hpp>
@@ -100,35 +103,72 @@ SOFTWARE.
 #include <boost/asio/ssl/stream.hpp>
 #endif // OB_BELLE_CONFIG_SSL_ON
 
+#include <boost/container/small_vector.hpp>
+
 #include <boost/config.hpp>
 
+#include <sys/stat.h>
+
+#ifdef BOOST_HAS_UNISTD_H
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif // BOOST_HAS_UNISTD_H
+
+#ifdef __linux__
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+#include <sys/sendfile.h>
+#include <sys/inotify.h>
+#include <dirent.h>
+#endif // __linux__
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif // __AVX2__
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+
 #include <cstdio>
+#include <cerrno>
+#include <cstring>
 #include <cctype>
 #include <cstdlib>
 #include <cstddef>
 #include <cstdint>
 #include <csignal>
+#include <ctime>
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <iomanip>
 #include <vector>
 #include <array>
 #include <deque>
+#include <list>
 #include <unordered_map>
-#include <unordered_set>
 #include <iterator>
 #include <algorithm>
 #include <functional>
 #include <regex>
 #include <memory>
+#include <new>
 #include <chrono>
+#include <random>
 #include <utility>
+#include <tuple>
 #include <initializer_list>
 #include <optional>
 #include <limits>
 #include <type_traits>
 #include <thread>
+#include <mutex>
+#include <atomic>
 
 namespace OB::Belle
 {
@@ -331,1393 +371,5074 @@ private:
   std::deque<m_iterator> _it;
 }; // class Ordered_Map
 
-namespace Detail
-{
-
-// prototypes
-inline std::string lowercase(std::string str);
-inline std::optional<std::string> extension(std::string const& path);
-inline std::vector<std::string> split(std::string const& str, std::string const& delim,
-  std::size_t size = std::numeric_limits<std::size_t>::max());
-
-// string to lowercase
-inline std::string lowercase(std::string str)
-{
-  auto const to_lower = [](char& c)
-  {
-    if (c >= 'A' && c <= 'Z')
-    {
-      c += 'a' - 'A';
-    }
-
-    return c;
-  };
-
-  for (char& c : str)
-  {
-    c = to_lower(c);
-  }
-
-  return str;
-}
-
-// find extension if present in a string path
-inline std::optional<std::string> extension(std::string const& path)
+// Flat_Multimap: an insert ordered multimap stored in a flat vector
+// the first N entries are stored inline without a heap allocation
+// lookups are linear, suited for a small number of entries
+template<typename K, typename V, std::size_t N = 8>
+class Flat_Multimap
 {
-  if (path.empty() || path.size() < 2)
-  {
-    return {};
-  }
+public:
 
-  auto const pos = path.rfind(".");
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<K, V>;
+  using container_type = boost::container::small_vector<value_type, N>;
+  using size_type = std::size_t;
+  using iterator = typename container_type::iterator;
+  using const_iterator = typename container_type::const_iterator;
 
-  if (pos == std::string::npos || pos == path.size() - 1)
+  // iterates over the entries matching a key
+  template<typename It>
+  class Key_Iterator
   {
-    return {};
-  }
-
-  return path.substr(pos + 1);
-}
+  public:
 
-// split a string by a delimiter 'n' times
-inline std::vector<std::string> split(std::string const& str,
-  std::string const& delim, std::size_t times)
-{
-  std::vector<std::string> vtok;
-  std::size_t start {0};
-  auto end = str.find(delim);
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename std::iterator_traits<It>::value_type;
+    using difference_type = typename std::iterator_traits<It>::difference_type;
+    using pointer = typename std::iterator_traits<It>::pointer;
+    using reference = typename std::iterator_traits<It>::reference;
 
-  while ((times-- > 0) && (end != std::string::npos))
-  {
-    vtok.emplace_back(str.substr(start, end - start));
-    start = end + delim.length();
-    end = str.find(delim, start);
-  }
-  vtok.emplace_back(str.substr(start, end));
+    Key_Iterator(It it, It end, K const& key) :
+      _it {it},
+      _end {end},
+      _key {key}
+    {
+      next();
+    }
 
-  return vtok;
-}
+    reference operator*() const
+    {
+      return *_it;
+    }
 
-// convert object into a string
-template<typename T>
-inline std::string to_string(T const& t)
-{
-  std::stringstream ss;
-  ss << t;
+    pointer operator->() const
+    {
+      return &*_it;
+    }
 
-  return ss.str();
-}
+    Key_Iterator& operator++()
+    {
+      ++_it;
+      next();
 
-#ifdef OB_BELLE_CONFIG_SSL_ON
-// TODO switch to boost::beast::ssl_stream when it moves out of experimental
-template<typename Next_Layer>
-class ssl_stream : public ssl::stream_base
-{
-// This class (ssl_stream) is a derivative work based on Boost.Beast,
-// orignal copyright below:
-/*
-  Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+      return *this;
+    }
 
-  Boost Software License - Version 1.0 - August 17th, 2003
+    Key_Iterator operator++(int)
+    {
+      auto res = *this;
+      ++(*this);
 
-  Permission is hereby granted, free of charge, to any person or organization
-  obtaining a copy of the software and accompanying documentation covered by
-  this license (the "Software") to use, reproduce, display, distribute,
-  execute, and transmit the Software, and to prepare derivative works of the
-  Software, and to permit third-parties to whom the Software is furnished to
-  do so, all subject to the following:
+      return res;
+    }
 
-  The copyright notices in the Software and this entire statement, including
-  the above license grant, this restriction and the following disclaimer,
-  must be included in all copies of the Software, in whole or in part, and
-  all derivative works of the Software, unless such copies or derivative
-  works are solely in the form of machine-executable object code generated by
-  a source language processor.
+    bool operator==(Key_Iterator const& rhs) const
+    {
+      return _it == rhs._it;
+    }
 
-  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-  FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
-  SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
-  FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
-  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
-  DEALINGS IN THE SOFTWARE.
-*/
+    bool operator!=(Key_Iterator const& rhs) const
+    {
+      return _it != rhs._it;
+    }
 
-  using stream_type = ssl::stream<Next_Layer>;
+  private:
 
-public:
+    void next()
+    {
+      while (_it != _end && ! (_it->first == _key))
+      {
+        ++_it;
+      }
+    }
 
-  using native_handle_type = typename stream_type::native_handle_type;
-  using impl_struct = typename stream_type::impl_struct;
-  using next_layer_type = typename stream_type::next_layer_type;
-  using lowest_layer_type = typename stream_type::lowest_layer_type;
-  using executor_type = typename stream_type::executor_type;
+    It _it;
+    It _end;
+    K _key;
+  }; // class Key_Iterator
 
-  ssl_stream(Next_Layer&& arg, ssl::context& ctx) :
-    _ptr {std::make_unique<stream_type>(std::move(arg), ctx)}
+  Flat_Multimap()
   {
   }
 
-  executor_type get_executor() noexcept
+  Flat_Multimap(std::initializer_list<value_type> const& lst) :
+    _vec(lst.begin(), lst.end())
   {
-    return _ptr->get_executor();
   }
 
-  native_handle_type native_handle()
+  ~Flat_Multimap()
   {
-    return _ptr->native_handle();
   }
 
-  next_layer_type const& next_layer() const
+  template<typename... Args>
+  iterator emplace(Args&&... args)
   {
-    return _ptr->next_layer();
-  }
+    _vec.emplace_back(std::forward<Args>(args)...);
 
-  next_layer_type& next_layer()
-  {
-    return _ptr->next_layer();
+    return std::prev(_vec.end());
   }
 
-  lowest_layer_type& lowest_layer()
+  iterator insert(value_type const& val)
   {
-    return _ptr->lowest_layer();
+    return emplace(val);
   }
 
-  lowest_layer_type const& lowest_layer() const
+  iterator insert(value_type&& val)
   {
-    return _ptr->lowest_layer();
+    return emplace(std::move(val));
   }
 
-  void set_verify_mode(ssl::verify_mode v)
+  iterator find(K const& key)
   {
-    _ptr->set_verify_mode(v);
+    return std::find_if(_vec.begin(), _vec.end(),
+      [&](auto const& e) { return e.first == key; });
   }
 
-  void set_verify_mode(ssl::verify_mode v, error_code& ec)
+  const_iterator find(K const& key) const
   {
-    _ptr->set_verify_mode(v, ec);
+    return std::find_if(_vec.begin(), _vec.end(),
+      [&](auto const& e) { return e.first == key; });
   }
 
-  void set_verify_depth(int depth)
+  size_type count(K const& key) const
   {
-    _ptr->set_verify_depth(depth);
+    return static_cast<size_type>(std::count_if(_vec.begin(), _vec.end(),
+      [&](auto const& e) { return e.first == key; }));
   }
 
-  void set_verify_depth(int depth, error_code& ec)
+  bool contains(K const& key) const
   {
-    _ptr->set_verify_depth(depth, ec);
+    return find(key) != _vec.end();
   }
 
-  template<typename VerifyCallback>
-  void set_verify_callback(VerifyCallback callback)
+  // the range of entries matching a key, in insert order
+  std::pair<Key_Iterator<iterator>, Key_Iterator<iterator>> equal_range(K const& key)
   {
-    _ptr->set_verify_callback(callback);
+    return {Key_Iterator<iterator>(_vec.begin(), _vec.end(), key),
+      Key_Iterator<iterator>(_vec.end(), _vec.end(), key)};
   }
 
-  template<typename VerifyCallback>
-  void set_verify_callback(VerifyCallback callback, error_code& ec)
+  std::pair<Key_Iterator<const_iterator>, Key_Iterator<const_iterator>>
+  equal_range(K const& key) const
   {
-    _ptr->set_verify_callback(callback, ec);
+    return {Key_Iterator<const_iterator>(_vec.begin(), _vec.end(), key),
+      Key_Iterator<const_iterator>(_vec.end(), _vec.end(), key)};
   }
 
-  void handshake(handshake_type type)
+  iterator erase(const_iterator it)
   {
-    _ptr->handshake(type);
+    return _vec.erase(it);
   }
 
-  void handshake(handshake_type type, error_code& ec)
+  size_type erase(K const& key)
   {
-    _ptr->handshake(type, ec);
-  }
+    auto const size = _vec.size();
+    _vec.erase(std::remove_if(_vec.begin(), _vec.end(),
+      [&](auto const& e) { return e.first == key; }), _vec.end());
 
-  template<typename ConstBufferSequence>
-  void handshake(handshake_type type, ConstBufferSequence const& buffers)
-  {
-    _ptr->handshake(type, buffers);
+    return size - _vec.size();
   }
 
-  template<typename ConstBufferSequence>
-  void handshake(handshake_type type, ConstBufferSequence const& buffers, error_code& ec)
+  Flat_Multimap& clear()
   {
-    _ptr->handshake(type, buffers, ec);
-  }
+    _vec.clear();
 
-  template<typename HandshakeHandler>
-  BOOST_ASIO_INITFN_RESULT_TYPE(HandshakeHandler, void(error_code))
-  async_handshake(handshake_type type, BOOST_ASIO_MOVE_ARG(HandshakeHandler) handler)
-  {
-    return _ptr->async_handshake(type, BOOST_ASIO_MOVE_CAST(HandshakeHandler)(handler));
+    return *this;
   }
 
-  template<typename ConstBufferSequence, typename BufferedHandshakeHandler>
-  BOOST_ASIO_INITFN_RESULT_TYPE(BufferedHandshakeHandler, void (error_code, std::size_t))
-  async_handshake(handshake_type type, ConstBufferSequence const& buffers,
-    BOOST_ASIO_MOVE_ARG(BufferedHandshakeHandler) handler)
+  Flat_Multimap& reserve(size_type size)
   {
-    return _ptr->async_handshake(type, buffers, BOOST_ASIO_MOVE_CAST(BufferedHandshakeHandler)(handler));
-  }
+    _vec.reserve(size);
 
-  void shutdown()
-  {
-    _ptr->shutdown();
+    return *this;
   }
 
-  void shutdown(error_code& ec)
+  size_type size() const
   {
-    _ptr->shutdown(ec);
+    return _vec.size();
   }
 
-  template<typename ShutdownHandler>
-  BOOST_ASIO_INITFN_RESULT_TYPE(ShutdownHandler, void (error_code))
-  async_shutdown(BOOST_ASIO_MOVE_ARG(ShutdownHandler) handler)
+  bool empty() const
   {
-    return _ptr->async_shutdown(BOOST_ASIO_MOVE_CAST(ShutdownHandler)(handler));
+    return _vec.empty();
   }
 
-  template<typename ConstBufferSequence>
-  std::size_t write_some(ConstBufferSequence const& buffers)
+  iterator begin()
   {
-    return _ptr->write_some(buffers);
+    return _vec.begin();
   }
 
-  template<typename ConstBufferSequence>
-  std::size_t write_some(ConstBufferSequence const& buffers, error_code& ec)
+  const_iterator begin() const
   {
-    return _ptr->write_some(buffers, ec);
+    return _vec.begin();
   }
 
-  template<typename ConstBufferSequence, typename WriteHandler>
-  BOOST_ASIO_INITFN_RESULT_TYPE(WriteHandler, void (error_code, std::size_t))
-  async_write_some(ConstBufferSequence const& buffers,
-    BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
+  const_iterator cbegin() const
   {
-    return _ptr->async_write_some(buffers, BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+    return _vec.cbegin();
   }
 
-  template<typename MutableBufferSequence>
-  std::size_t read_some(MutableBufferSequence const& buffers)
+  iterator end()
   {
-    return _ptr->read_some(buffers);
+    return _vec.end();
   }
 
-  template<typename MutableBufferSequence>
-  std::size_t read_some(MutableBufferSequence const& buffers, error_code& ec)
+  const_iterator end() const
   {
-    return _ptr->read_some(buffers, ec);
+    return _vec.end();
   }
 
-  template<typename MutableBufferSequence, typename ReadHandler>
-  BOOST_ASIO_INITFN_RESULT_TYPE(ReadHandler, void(error_code, std::size_t))
-  async_read_some(MutableBufferSequence const& buffers,
-    BOOST_ASIO_MOVE_ARG(ReadHandler) handler)
+  const_iterator cend() const
   {
-    return _ptr->async_read_some(buffers, BOOST_ASIO_MOVE_CAST(ReadHandler)(handler));
+    return _vec.cend();
   }
 
-  template<typename SyncStream>
-  friend void teardown(websocket::role_type,
-    ssl_stream<SyncStream>& stream, error_code& ec);
+private:
 
-  template<typename AsyncStream, typename TeardownHandler>
-  friend void async_teardown(websocket::role_type,
-    ssl_stream<AsyncStream>& stream, TeardownHandler&& handler);
+  container_type _vec {};
+}; // class Flat_Multimap
 
-private:
+namespace Detail
+{
 
-  std::unique_ptr<stream_type> _ptr;
-}; // class ssl_stream
+// prototypes
+inline std::string lowercase(std::string str);
+inline std::optional<std::string> extension(std::string const& path);
+inline std::vector<std::string> split(std::string const& str, std::string const& delim,
+  std::size_t size = std::numeric_limits<std::size_t>::max());
+inline std::size_t url_find_escape(std::string_view str, std::size_t pos);
+inline std::string url_encode(std::string_view str);
+inline std::string url_decode(std::string_view str);
+inline bool path_resolve(std::string_view target, std::string* path);
+inline std::string http_date(std::time_t time);
+inline std::optional<std::time_t> http_date_parse(std::string_view str);
+inline std::string http_etag(std::time_t mtime, std::uint64_t size);
+inline bool http_etag_match(std::string_view header, std::string_view etag);
+inline std::string http_boundary();
+
+// inclusive byte ranges
+using Ranges = std::vector<std::pair<std::uint64_t, std::uint64_t>>;
+
+inline std::optional<Ranges> http_ranges(std::string_view header, std::uint64_t size,
+  std::size_t max);
+inline bool http_accepts(std::string_view header, std::string_view coding);
+
+// names used in http dates
+inline constexpr std::array<std::string_view, 7> http_days
+{
+  "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+};
 
-template<typename SyncStream>
-inline void teardown(websocket::role_type role,
-  ssl_stream<SyncStream>& stream, error_code& ec)
+inline constexpr std::array<std::string_view, 12> http_months
 {
-  websocket::teardown(role, *stream._ptr, ec);
-}
+  "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
 
-template<typename AsyncStream, typename TeardownHandler>
-inline void async_teardown(websocket::role_type role,
-  ssl_stream<AsyncStream>& stream, TeardownHandler&& handler)
+// precompressed file encodings and their extensions in order of preference
+inline constexpr std::array<std::pair<std::string_view, std::string_view>, 3> precompressed
+{{
+  {"br", ".br"},
+  {"zstd", ".zst"},
+  {"gzip", ".gz"},
+}};
+
+// url encoding lookup tables
+struct Url_Table
 {
-  websocket::async_teardown(role, *stream._ptr, std::forward<TeardownHandler>(handler));
-}
-#endif // OB_BELLE_CONFIG_SSL_ON
+  // value of each hex digit, -1 if not a hex digit
+  std::array<signed char, 256> hex {};
 
-} // namespace Detail
+  // true if the character is unreserved and not percent-encoded
+  std::array<bool, 256> unreserved {};
+}; // struct Url_Table
 
-std::unordered_map<std::string, std::string> const mime_types
+constexpr Url_Table url_table_init()
 {
-  {"html", "text/html"},
-  {"htm", "text/html"},
-  {"shtml", "text/html"},
-  {"css", "text/css"},
-  {"xml", "text/xml"},
-  {"gif", "image/gif"},
-  {"jpg", "image/jpg"},
-  {"jpeg", "image/jpg"},
-  {"js", "application/javascript"},
-  {"atom", "application/atom+xml"},
-  {"rss", "application/rss+xml"},
-  {"mml", "text/mathml"},
-  {"txt", "text/plain"},
-  {"jad", "text/vnd.sun.j2me.app-descriptor"},
-  {"wml", "text/vnd.wap.wml"},
-  {"htc", "text/x-component"},
-  {"png", "image/png"},
-  {"tif", "image/tiff"},
-  {"tiff", "image/tiff"},
-  {"wbmp", "image/vnd.wap.wbmp"},
-  {"ico", "image/x-icon"},
-  {"jng", "image/x-jng"},
-  {"bmp", "image/x-ms-bmp"},
-  {"svg", "image/svg+xml"},
-  {"svgz", "image/svg+xml"},
-  {"webp", "image/webp"},
-  {"woff", "application/font-woff"},
-  {"jar", "application/java-archive"},
-  {"war", "application/java-archive"},
-  {"ear", "application/java-archive"},
-  {"json", "application/json"},
-  {"hqx", "application/mac-binhex40"},
-  {"doc", "application/msword"},
-  {"pdf", "application/pdf"},
-  {"ps", "application/postscript"},
-  {"eps", "application/postscript"},
-  {"ai", "application/postscript"},
-  {"rtf", "application/rtf"},
-  {"m3u8", "application/vnd.apple.mpegurl"},
-  {"xls", "application/vnd.ms-excel"},
-  {"eot", "application/vnd.ms-fontobject"},
-  {"ppt", "application/vnd.ms-powerpoint"},
-  {"wmlc", "application/vnd.wap.wmlc"},
-  {"kml", "application/vnd.google-earth.kml+xml"},
-  {"kmz", "application/vnd.google-earth.kmz"},
-  {"7z", "application/x-7z-compressed"},
-  {"cco", "application/x-cocoa"},
-  {"jardiff", "application/x-java-archive-diff"},
-  {"jnlp", "application/x-java-jnlp-file"},
-  {"run", "application/x-makeself"},
-  {"pm", "application/x-perl"},
-  {"pl", "application/x-perl"},
-  {"pdb", "application/x-pilot"},
-  {"prc", "application/x-pilot"},
-  {"rar", "application/x-rar-compressed"},
-  {"rpm", "application/x-redhat-package-manager"},
-  {"sea", "application/x-sea"},
-  {"swf", "application/x-shockwave-flash"},
-  {"sit", "application/x-stuffit"},
-  {"tk", "application/x-tcl"},
-  {"tcl", "application/x-tcl"},
-  {"crt", "application/x-x509-ca-cert"},
-  {"pem", "application/x-x509-ca-cert"},
-  {"der", "application/x-x509-ca-cert"},
-  {"xpi", "application/x-xpinstall"},
-  {"xhtml", "application/xhtml+xml"},
-  {"xspf", "application/xspf+xml"},
-  {"zip", "application/zip"},
-  {"dll", "application/octet-stream"},
-  {"exe", "application/octet-stream"},
-  {"bin", "application/octet-stream"},
-  {"deb", "application/octet-stream"},
-  {"dmg", "application/octet-stream"},
-  {"img", "application/octet-stream"},
-  {"iso", "application/octet-stream"},
-  {"msm", "application/octet-stream"},
-  {"msp", "application/octet-stream"},
-  {"msi", "application/octet-stream"},
-  {"docx", "application/vnd.openxmlformats-officedocument.wordprocessingml.document"},
-  {"xlsx", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"},
-  {"pptx", "application/vnd.openxmlformats-officedocument.presentationml.presentation"},
-  {"kar", "audio/midi"},
-  {"midi", "audio/midi"},
-  {"mid", "audio/midi"},
-  {"mp3", "audio/mpeg"},
-  {"ogg", "audio/ogg"},
-  {"m4a", "audio/x-m4a"},
-  {"ra", "audio/x-realaudio"},
-  {"3gp", "video/3gpp"},
-  {"3gpp", "video/3gpp"},
-  {"ts", "video/mp2t"},
-  {"mp4", "video/mp4"},
-  {"mpg", "video/mpeg"},
-  {"mpeg", "video/mpeg"},
-  {"mov", "video/quicktime"},
-  {"webm", "video/webm"},
-  {"flv", "video/x-flv"},
-  {"m4v", "video/x-m4v"},
-  {"mng", "video/x-mng"},
-  {"asf", "video/x-ms-asf"},
-  {"asx", "video/x-ms-asf"},
-  {"wmv", "video/x-ms-wmv"},
-  {"avi", "video/x-msvideo"},
-};
+  Url_Table res {};
 
-// prototypes
-inline std::string mime_type(std::string const& path);
+  for (std::size_t i = 0; i < 256; ++i)
+  {
+    res.hex[i] = -1;
 
-// find the mime type of a string path
-inline std::string mime_type(std::string const& path)
-{
-  if (auto ext = Detail::extension(path))
+    auto const c = static_cast<char>(i);
+
+    res.unreserved[i] = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+      (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.' || c == '~';
+  }
+
+  for (std::size_t i = 0; i < 10; ++i)
   {
-    auto const str = Detail::lowercase(ext.value());
+    res.hex['0' + i] = static_cast<signed char>(i);
+  }
 
-    if (mime_types.find(str) != mime_types.end())
-    {
-      return mime_types.at(str);
-    }
+  for (std::size_t i = 0; i < 6; ++i)
+  {
+    res.hex['a' + i] = static_cast<signed char>(10 + i);
+    res.hex['A' + i] = static_cast<signed char>(10 + i);
   }
 
-  return "application/octet-stream";
+  return res;
 }
 
-class Request : public http::request<http::string_body>
+inline constexpr Url_Table url_table {url_table_init()};
+
+// index of the lowest set bit
+inline unsigned int ctz(std::uint32_t val)
 {
-  using Base = http::request<http::string_body>;
+#ifdef _MSC_VER
+  unsigned long res;
+  _BitScanForward(&res, val);
+  return static_cast<unsigned int>(res);
+#else
+  return static_cast<unsigned int>(__builtin_ctz(val));
+#endif // _MSC_VER
+}
 
-public:
+// string to lowercase
+inline std::string lowercase(std::string str)
+{
+  auto const to_lower = [](char& c)
+  {
+    if (c >= 'A' && c <= 'Z')
+    {
+      c += 'a' - 'A';
+    }
 
-  using Path = std::vector<std::string>;
-  using Params = std::unordered_multimap<std::string, std::string>;
+    return c;
+  };
 
-  // inherit base constructors
-  using http::request<http::string_body>::message;
+  for (char& c : str)
+  {
+    c = to_lower(c);
+  }
 
-  // default constructor
-  Request() = default;
+  return str;
+}
 
-  // copy constructor
-  Request(Request const&) = default;
+// find extension if present in a string path
+inline std::optional<std::string> extension(std::string const& path)
+{
+  if (path.empty() || path.size() < 2)
+  {
+    return {};
+  }
 
-  // move constructor
-  Request(Request&&) = default;
+  auto const pos = path.rfind(".");
 
-  // copy assignment
-  Request& operator=(Request const&) = default;
+  if (pos == std::string::npos || pos == path.size() - 1)
+  {
+    return {};
+  }
 
-  // move assignment
-  Request& operator=(Request&& rhs) = default;
+  return path.substr(pos + 1);
+}
 
-  // default deconstructor
-  ~Request() = default;
+// split a string by a delimiter 'n' times
+inline std::vector<std::string> split(std::string const& str,
+  std::string const& delim, std::size_t times)
+{
+  std::vector<std::string> vtok;
+  std::size_t start {0};
+  auto end = str.find(delim);
 
-  Request&& move() noexcept
+  while ((times-- > 0) && (end != std::string::npos))
   {
-    return std::move(*this);
+    vtok.emplace_back(str.substr(start, end - start));
+    start = end + delim.length();
+    end = str.find(delim, start);
   }
+  vtok.emplace_back(str.substr(start, end));
 
-  // get the path
-  Path& path()
-  {
-    return _path;
-  }
+  return vtok;
+}
 
-  // get the query parameters
-  Params& params()
-  {
-    return _params;
-  }
+// find the next '%' or '+' in a url encoded string starting at pos
+// scans 32 or 16 byte blocks at a time when AVX2 or SSE2 is available
+inline std::size_t url_find_escape(std::string_view str, std::size_t pos)
+{
+  auto const data = str.data();
+  auto const size = str.size();
 
-  // serialize path and query parameters to the target
-  void params_serialize()
+#ifdef __AVX2__
   {
-    std::string path {target().to_string()};
-
-    _path.clear();
-    _path.emplace_back(path);
+    auto const pct = _mm256_set1_epi8('%');
+    auto const plus = _mm256_set1_epi8('+');
 
-    if (! _params.empty())
+    for (; pos + 32 <= size; pos += 32)
     {
-      path += "?";
-      auto it = _params.begin();
-      for (; it != _params.end(); ++it)
+      auto const blk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + pos));
+      auto const mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(blk, pct), _mm256_cmpeq_epi8(blk, plus))));
+
+      if (mask)
       {
-        path += url_encode(it->first) + "=" + url_encode(it->second) + "&";
+        return pos + ctz(mask);
       }
-      path.pop_back();
     }
-
-    target(path);
   }
+#endif // __AVX2__
 
-  // parse the query parameters from the target
-  void params_parse()
+#ifdef __SSE2__
   {
-    std::string path {target().to_string()};
-
-    // separate the query params
-    auto params = Detail::split(path, "?", 1);
+    auto const pct = _mm_set1_epi8('%');
+    auto const plus = _mm_set1_epi8('+');
 
-    // set params
-    if (params.size() == 2)
+    for (; pos + 16 <= size; pos += 16)
     {
-      auto kv = Detail::split(params.at(1), "&");
+      auto const blk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + pos));
+      auto const mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(blk, pct), _mm_cmpeq_epi8(blk, plus))));
 
-      for (auto const& e : kv)
+      if (mask)
       {
-        if (e.empty())
-        {
-          continue;
-        }
+        return pos + ctz(mask);
+      }
+    }
+  }
+#endif // __SSE2__
 
-        auto k_v = Detail::split(e, "=", 1);
+  for (; pos < size; ++pos)
+  {
+    if (data[pos] == '%' || data[pos] == '+')
+    {
+      return pos;
+    }
+  }
 
-        if (k_v.size() == 1)
-        {
-          _params.emplace(url_decode(e), "");
-        }
+  return std::string_view::npos;
+}
 
-        else if (k_v.size() == 2)
-        {
-          _params.emplace(url_decode(k_v.at(0)), url_decode(k_v.at(1)));
-        }
+// percent-encode a string, spaces are encoded as '+'
+inline std::string url_encode(std::string_view str)
+{
+  static constexpr char hex[] {"0123456789ABCDEF"};
 
-        continue;
-      }
-    }
-  }
+  std::string res;
+  res.resize(str.size() * 3);
 
-private:
+  auto out = &res[0];
 
-  std::string hex_encode(char const c)
+  for (auto const e : str)
   {
-    char s[3];
+    auto const c = static_cast<unsigned char>(e);
 
-    if (c & 0x80)
+    if (url_table.unreserved[c])
     {
-      std::snprintf(&s[0], 3, "%02X",
-        static_cast<unsigned int>(c & 0xff)
-      );
+      *out++ = e;
+    }
+    else if (e == ' ')
+    {
+      *out++ = '+';
     }
     else
     {
-      std::snprintf(&s[0], 3, "%02X",
-        static_cast<unsigned int>(c)
-      );
+      *out++ = '%';
+      *out++ = hex[c >> 4];
+      *out++ = hex[c & 0x0f];
     }
-
-    return std::string(s);
   }
 
-  char hex_decode(std::string const& s)
-  {
-    unsigned int n;
+  res.resize(static_cast<std::size_t>(out - res.data()));
+
+  return res;
+}
 
-    std::sscanf(s.data(), "%x", &n);
+// decode a percent-encoded string, '+' is decoded as a space
+// spans without escapes are copied in bulk
+inline std::string url_decode(std::string_view str)
+{
+  std::string res;
+  res.resize(str.size());
 
-    return static_cast<char>(n);
-  }
+  auto out = &res[0];
+  std::size_t pos {0};
 
-  std::string url_encode(std::string const& str)
+  for (;;)
   {
-    std::string res;
-    res.reserve(str.size());
+    auto const end = url_find_escape(str, pos);
+    auto const len = (end == std::string_view::npos ? str.size() : end) - pos;
 
-    for (auto const& e : str)
+    if (len)
     {
-      if (e == ' ')
-      {
-        res += "+";
-      }
-      else if (std::isalnum(static_cast<unsigned char>(e)) ||
-        e == '-' || e == '_' || e == '.' || e == '~')
-      {
-        res += e;
-      }
-      else
-      {
-        res += "%" + hex_encode(e);
-      }
+      std::memcpy(out, str.data() + pos, len);
+      out += len;
     }
 
-    return res;
-  }
+    if (end == std::string_view::npos)
+    {
+      break;
+    }
 
-  std::string url_decode(std::string const& str)
-  {
-    std::string res;
-    res.reserve(str.size());
+    pos = end + 1;
 
-    for (std::size_t i = 0; i < str.size(); ++i)
+    if (str[end] == '+')
     {
-      if (str[i] == '+')
-      {
-        res += " ";
-      }
-      else if (str[i] == '%' && i + 2 < str.size() &&
-        std::isxdigit(static_cast<unsigned char>(str[i + 1])) &&
-        std::isxdigit(static_cast<unsigned char>(str[i + 2])))
-      {
-        res += hex_decode(str.substr(i + 1, 2));
-        i += 2;
-      }
-      else
+      *out++ = ' ';
+      continue;
+    }
+
+    if (end + 2 < str.size())
+    {
+      auto const hi = url_table.hex[static_cast<unsigned char>(str[end + 1])];
+      auto const lo = url_table.hex[static_cast<unsigned char>(str[end + 2])];
+
+      if (hi >= 0 && lo >= 0)
       {
-        res += str[i];
+        *out++ = static_cast<char>((hi << 4) | lo);
+        pos += 2;
+        continue;
       }
     }
 
-    return res;
+    *out++ = '%';
   }
 
-  Path _path {};
-  Params _params {};
-}; // Request
-
-// store a type erased websocket
-struct Websocket_Session
-{
-  // default deconstructor
-  virtual ~Websocket_Session() = default;
+  res.resize(static_cast<std::size_t>(out - res.data()));
 
-  // send a message
-  virtual void send(std::string const&&) = 0;
-}; // struct Websocket_Session
+  return res;
+}
 
-#ifdef OB_BELLE_CONFIG_SERVER_ON
-class Server
+// normalize the path of a request target in a single pass
+// the query is removed, percent-escapes are decoded, and empty and '.' segments
+// are dropped, a trailing '/' is kept
+// returns false if the target does not start with '/', has an invalid escape,
+// a '..' segment, or an escaped '/' or null character
+// path may be nullptr to only validate the target
+inline bool path_resolve(std::string_view target, std::string* path)
 {
-public:
+  target = target.substr(0, target.find_first_of("?#"));
 
-  // NOTE Channel implementation is NOT thread safe
-  class Channel
+  if (target.empty() || target[0] != '/')
   {
-  public:
+    return false;
+  }
 
-    Channel()
+  if (path)
+  {
+    path->clear();
+    path->reserve(target.size());
+  }
+
+  // start of the current segment in the path, its length and number of dots
+  std::size_t mark {0};
+  std::size_t len {0};
+  std::size_t dots {0};
+
+  // drop an empty or '.' segment, reject a '..' segment
+  auto const end_segment = [&]()
+  {
+    if (len == 2 && dots == 2)
     {
+      return false;
     }
 
-    void join(Websocket_Session& socket_)
+    if (len == dots && len < 2 && path)
     {
-      _sockets.insert(&socket_);
+      path->resize(mark);
     }
 
-    void leave(Websocket_Session& socket_)
+    return true;
+  };
+
+  for (std::size_t i = 0; i < target.size(); ++i)
+  {
+    auto c = target[i];
+
+    if (c == '/')
     {
-      _sockets.erase(&socket_);
+      if (i != 0 && ! end_segment())
+      {
+        return false;
+      }
+
+      if (path)
+      {
+        mark = path->size();
+        path->push_back('/');
+      }
+
+      len = 0;
+      dots = 0;
+      continue;
     }
 
-    void broadcast(std::string const&& str_) const
+    if (c == '%')
     {
-      for(auto const e : _sockets)
+      if (i + 2 >= target.size())
+      {
+        return false;
+      }
+
+      auto const hi = url_table.hex[static_cast<unsigned char>(target[i + 1])];
+      auto const lo = url_table.hex[static_cast<unsigned char>(target[i + 2])];
+
+      if (hi < 0 || lo < 0)
+      {
+        return false;
+      }
+
+      c = static_cast<char>((hi << 4) | lo);
+      i += 2;
+
+      if (c == '/' || c == '\0')
       {
-        e->send(std::move(str_));
+        return false;
       }
     }
 
-    std::size_t size() const
+    ++len;
+
+    if (c == '.')
     {
-      return _sockets.size();
+      ++dots;
     }
 
-  private:
-
-    std::unordered_set<Websocket_Session*> _sockets;
-  }; // class Channel
+    if (path)
+    {
+      path->push_back(c);
+    }
+  }
 
-  // NOTE Channels implementation is NOT thread safe
-  using Channels = std::unordered_map<std::string, Channel>;
+  if (! end_segment())
+  {
+    return false;
+  }
 
-  template<typename Body>
-  struct Http_Ctx_Basic
+  // the last segment was dropped, keep its slash
+  if (len == dots && len < 2 && path)
   {
-    Request req {};
-    http::response<Body> res {};
-    std::shared_ptr<void> data {nullptr};
-  }; // class Http_Ctx_Basic
+    path->push_back('/');
+  }
 
-  using Http_Ctx = Http_Ctx_Basic<http::string_body>;
+  return true;
+}
 
-  class Websocket_Ctx
+// format a time as an http date, ex. 'Sun, 06 Nov 1994 08:49:37 GMT'
+inline std::string http_date(std::time_t time)
+{
+  std::tm tm {};
+
+#ifdef _MSC_VER
+  gmtime_s(&tm, &time);
+#else
+  gmtime_r(&time, &tm);
+#endif // _MSC_VER
+
+  char buf[64];
+  std::snprintf(&buf[0], sizeof(buf), "%.3s, %02d %.3s %04d %02d:%02d:%02d GMT",
+    http_days[static_cast<std::size_t>(tm.tm_wday % 7)].data(), tm.tm_mday,
+    http_months[static_cast<std::size_t>(tm.tm_mon % 12)].data(), tm.tm_year + 1900,
+    tm.tm_hour, tm.tm_min, tm.tm_sec);
+
+  return std::string(buf);
+}
+
+// parse an http date in the preferred imf-fixdate format
+// the obsolete rfc 850 and asctime formats are not accepted
+inline std::optional<std::time_t> http_date_parse(std::string_view str)
+{
+  if (str.size() != 29 || str.substr(3, 2) != ", " || str.substr(25) != " GMT" ||
+    str[7] != ' ' || str[11] != ' ' || str[16] != ' ' || str[19] != ':' || str[22] != ':')
   {
-  public:
+    return {};
+  }
 
-    Websocket_Ctx(Websocket_Session& socket_, Request&& req_,
-      Channels& channels_) :
-      socket {&socket_},
-      req {std::move(req_)},
-      channels {channels_}
+  auto const num = [&](std::size_t pos, std::size_t len)
+  {
+    long res {0};
+
+    for (auto const e : str.substr(pos, len))
     {
+      if (e < '0' || e > '9')
+      {
+        return -1L;
+      }
+
+      res = res * 10 + (e - '0');
     }
 
-    ~Websocket_Ctx()
+    return res;
+  };
+
+  long month {0};
+
+  while (month < 12 && str.substr(8, 3) != http_months[static_cast<std::size_t>(month)])
+  {
+    ++month;
+  }
+
+  auto const day = num(5, 2);
+  auto const year = num(12, 4);
+  auto const hour = num(17, 2);
+  auto const min = num(20, 2);
+  auto const sec = num(23, 2);
+
+  if (month == 12 || day < 1 || day > 31 || year < 1970 || hour > 23 || min > 59 || sec > 60 ||
+    hour < 0 || min < 0 || sec < 0)
+  {
+    return {};
+  }
+
+  // days since the epoch from the civil date
+  auto const y = year - (month < 2);
+  auto const era = y / 400;
+  auto const yoe = y - era * 400;
+  auto const doy = (153 * ((month + 10) % 12) + 2) / 5 + day - 1;
+  auto const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  auto const days = static_cast<std::time_t>(era * 146097 + doe - 719468);
+
+  return days * 86400 + hour * 3600 + min * 60 + sec;
+}
+
+// create an entity tag from a modification time and size
+inline std::string http_etag(std::time_t mtime, std::uint64_t size)
+{
+  char buf[48];
+  std::snprintf(&buf[0], sizeof(buf), "\"%llx-%llx\"",
+    static_cast<unsigned long long>(mtime),
+    static_cast<unsigned long long>(size));
+
+  return std::string(buf);
+}
+
+// check if an if-none-match header matches an entity tag
+// uses the weak comparison, ignoring the 'W/' prefix
+inline bool http_etag_match(std::string_view header, std::string_view etag)
+{
+  if (etag.substr(0, 2) == "W/")
+  {
+    etag.remove_prefix(2);
+  }
+
+  for (std::size_t pos = 0; pos < header.size();)
+  {
+    auto const c = header[pos];
+
+    if (c == ' ' || c == '\t' || c == ',')
     {
+      ++pos;
+      continue;
     }
 
-    void send(std::string const&& str_) const
+    if (c == '*')
     {
-      socket->send(std::move(str_));
+      return true;
     }
 
-    void broadcast(std::string const&& str_) const
+    if (header.substr(pos, 2) == "W/")
     {
-      for (auto const& e : channels)
-      {
-        e.second.broadcast(std::move(str_));
-      }
+      pos += 2;
     }
 
-    Websocket_Session* socket;
-    Request req;
-    Channels& channels;
-    std::string msg {};
-    std::shared_ptr<void> data {nullptr};
-  }; // class Websocket_Ctx
+    if (pos >= header.size() || header[pos] != '"')
+    {
+      return false;
+    }
 
-  // callbacks
-  using fn_on_signal = std::function<void(error_code, int)>;
-  using fn_on_http = std::function<void(Http_Ctx&)>;
-  using fn_on_websocket = std::function<void(Websocket_Ctx&)>;
+    auto const end = header.find('"', pos + 1);
 
-  struct fns_on_websocket
-  {
-    fns_on_websocket(fn_on_websocket const& begin_,
-      fn_on_websocket const& data_, fn_on_websocket const& end_) :
-      begin {begin_},
-      data {data_},
-      end {end_}
+    if (end == std::string_view::npos)
     {
+      return false;
     }
 
-    fn_on_websocket begin {};
-    fn_on_websocket data {};
-    fn_on_websocket end {};
-  }; // struct fns_on_websocket
+    if (header.substr(pos, end - pos + 1) == etag)
+    {
+      return true;
+    }
 
-  // aliases
-  using Http_Routes =
-    Ordered_Map<std::string, std::unordered_map<int, fn_on_http>>;
+    pos = end + 1;
+  }
 
-  using Websocket_Routes =
-    std::vector<std::pair<std::string, fns_on_websocket>>;
+  return false;
+}
 
-private:
+// create a random multipart boundary
+inline std::string http_boundary()
+{
+  thread_local std::mt19937_64 gen {std::random_device {}()};
 
-  struct Attr
-  {
-#ifdef OB_BELLE_CONFIG_SSL_ON
-    // use ssl
-    bool ssl {false};
+  char buf[24];
+  std::snprintf(&buf[0], sizeof(buf), "%016llx",
+    static_cast<unsigned long long>(gen()));
 
-    // ssl context
-    ssl::context ssl_context {ssl::context::tlsv12_server};
-#endif // OB_BELLE_CONFIG_SSL_ON
+  return std::string(buf);
+}
 
-    // the public directory for serving static files
-    std::string public_dir {};
+// parse a 'bytes' range header against a size
+// returns nullopt if the header is invalid or has more than max ranges,
+// otherwise the satisfiable ranges clamped to the size, which may be empty
+inline std::optional<Ranges> http_ranges(std::string_view header, std::uint64_t size,
+  std::size_t max)
+{
+  auto const trim = [](std::string_view str)
+  {
+    auto const begin = str.find_first_not_of(" \t");
 
-    // default index filename for the public directory
-    std::string index_file {"index.html"};
+    if (begin == std::string_view::npos)
+    {
+      return std::string_view {};
+    }
 
-    // socket timeout
-    std::chrono::seconds timeout {10};
+    return str.substr(begin, str.find_last_not_of(" \t") - begin + 1);
+  };
 
-    // serve static files from public directory
-    bool http_static {true};
+  auto const num = [](std::string_view str) -> std::optional<std::uint64_t>
+  {
+    if (str.empty() || str.size() > 19 || str.find_first_not_of("0123456789") != std::string_view::npos)
+    {
+      return {};
+    }
 
-    // serve dynamic content
-    bool http_dynamic {true};
+    std::uint64_t res {0};
 
-    // upgrade http to websocket connection
-    bool websocket {true};
+    for (auto const e : str)
+    {
+      res = res * 10 + static_cast<std::uint64_t>(e - '0');
+    }
 
-    // default http headers
-    Headers http_headers {};
+    return res;
+  };
 
-    // http routes
-    Http_Routes http_routes {};
+  auto const eq = header.find('=');
 
-    // websocket routes
-    Websocket_Routes websocket_routes {};
+  if (eq == std::string_view::npos || ! beast::iequals(
+    beast::string_view {header.data(), eq}, "bytes"))
+  {
+    return {};
+  }
 
-    // callbacks for http
-    fn_on_http on_http_error {};
-    fn_on_http on_http_connect {};
-    fn_on_http on_http_disconnect {};
+  Ranges res;
+  std::size_t count {0};
 
-    // callbacks for websocket
-    fn_on_websocket on_websocket_error {};
-    fn_on_websocket on_websocket_connect {};
-    fn_on_websocket on_websocket_disconnect {};
+  for (std::size_t pos = eq + 1; pos != std::string_view::npos;)
+  {
+    auto const end = header.find(',', pos);
+    auto const item = trim(header.substr(pos, end == std::string_view::npos ? end : end - pos));
+    pos = end == std::string_view::npos ? end : end + 1;
 
-    // websocket channels
-    Channels channels {};
-  }; // struct Attr
+    if (item.empty())
+    {
+      continue;
+    }
 
-  template<typename Derived>
-  class Websocket_Base : public Websocket_Session
-  {
-    Derived& derived()
+    if (++count > max)
     {
-      return static_cast<Derived&>(*this);
+      return {};
     }
 
-  public:
+    auto const dash = item.find('-');
 
-    Websocket_Base(net::io_context& io_, std::shared_ptr<Attr> const attr_,
-      Request&& req_, fns_on_websocket const& on_websocket_) :
-      _attr {attr_},
-      _ctx {static_cast<Derived&>(*this), std::move(req_), _attr->channels},
-      _on_websocket {on_websocket_},
-      _strand {io_.get_executor()}
+    if (dash == std::string_view::npos)
     {
+      return {};
     }
 
-    ~Websocket_Base()
+    // suffix range, the last n bytes
+    if (dash == 0)
     {
-      // leave channel
-      _attr->channels.at(_ctx.req.path().at(0)).leave(derived());
+      auto const len = num(item.substr(1));
 
-      if (_on_websocket.end)
+      if (! len)
       {
-        try
-        {
-          // run user function
-          _on_websocket.end(_ctx);
-        }
-        catch (...)
-        {
-          this->handle_error();
-        }
+        return {};
       }
 
-      if (_attr->on_websocket_disconnect)
+      if (len.value() > 0 && size > 0)
       {
-        try
-        {
-          // run user function
-          _attr->on_websocket_disconnect(_ctx);
-        }
-        catch (...)
-        {
-          this->handle_error();
+        res.emplace_back(size - std::min(len.value(), size), size - 1);
+      }
+
+      continue;
+    }
+
+    auto const first = num(item.substr(0, dash));
+    auto const last = dash + 1 == item.size() ?
+      std::optional<std::uint64_t> {std::numeric_limits<std::uint64_t>::max()} :
+      num(item.substr(dash + 1));
+
+    if (! first || ! last || last.value() < first.value())
+    {
+      return {};
+    }
+
+    if (first.value() < size)
+    {
+      res.emplace_back(first.value(), std::min(last.value(), size - 1));
+    }
+  }
+
+  if (count == 0)
+  {
+    return {};
+  }
+
+  return res;
+}
+
+// check if a header such as accept-encoding accepts a coding
+// the coding is accepted if listed, or matched by '*', with a nonzero quality
+inline bool http_accepts(std::string_view header, std::string_view coding)
+{
+  auto const trim = [](std::string_view str)
+  {
+    auto const begin = str.find_first_not_of(" \t");
+
+    if (begin == std::string_view::npos)
+    {
+      return std::string_view {};
+    }
+
+    return str.substr(begin, str.find_last_not_of(" \t") - begin + 1);
+  };
+
+  // a quality of zero is written as '0', '0.', or '0.0' to '0.000'
+  auto const accepted = [&](std::string_view params)
+  {
+    for (std::size_t pos = 0; pos != std::string_view::npos;)
+    {
+      auto const end = params.find(';', pos);
+      auto const param = trim(params.substr(pos, end == std::string_view::npos ? end : end - pos));
+      pos = end == std::string_view::npos ? end : end + 1;
+
+      if (param.size() > 1 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=')
+      {
+        return param.substr(2).find_first_not_of("0.") != std::string_view::npos;
+      }
+    }
+
+    return true;
+  };
+
+  std::optional<bool> wildcard;
+
+  for (std::size_t pos = 0; pos != std::string_view::npos;)
+  {
+    auto const end = header.find(',', pos);
+    auto const item = header.substr(pos, end == std::string_view::npos ? end : end - pos);
+    pos = end == std::string_view::npos ? end : end + 1;
+
+    auto const semi = item.find(';');
+    auto const name = trim(item.substr(0, semi));
+    auto const params = semi == std::string_view::npos ? std::string_view {} : item.substr(semi + 1);
+
+    if (beast::iequals(beast::string_view {name.data(), name.size()},
+      beast::string_view {coding.data(), coding.size()}))
+    {
+      return accepted(params);
+    }
+
+    if (name == "*")
+    {
+      wildcard = accepted(params);
+    }
+  }
+
+  return wildcard.value_or(false);
+}
+
+// convert object into a string
+template<typename T>
+inline std::string to_string(T const& t)
+{
+  std::stringstream ss;
+  ss << t;
+
+  return ss.str();
+}
+
+// Function: a copyable type erased callable with inline storage
+// callables that fit in the buffer are stored without a heap allocation
+// larger callables fall back to the heap
+template<typename Sig, std::size_t Size = 48>
+class Function;
+
+template<typename R, typename... Args, std::size_t Size>
+class Function<R(Args...), Size>
+{
+  template<typename T>
+  struct is_std_function : std::false_type
+  {
+  };
+
+  template<typename T>
+  struct is_std_function<std::function<T>> : std::true_type
+  {
+  };
+
+public:
+
+  Function() noexcept
+  {
+  }
+
+  Function(std::nullptr_t) noexcept
+  {
+  }
+
+  template<typename F, typename = std::enable_if_t<
+    ! std::is_same_v<std::decay_t<F>, Function> &&
+    std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+  Function(F&& fn)
+  {
+    using T = std::decay_t<F>;
+
+    // empty callables stay empty
+    if constexpr (std::is_pointer_v<T> || is_std_function<T>::value)
+    {
+      if (! fn)
+      {
+        return;
+      }
+    }
+
+    if constexpr (is_inline<T>)
+    {
+      ::new (static_cast<void*>(_buf)) T(std::forward<F>(fn));
+      _ops = &Inline<T>::ops;
+    }
+    else
+    {
+      ::new (static_cast<void*>(_buf)) T*(new T(std::forward<F>(fn)));
+      _ops = &Heap<T>::ops;
+    }
+  }
+
+  Function(Function const& rhs)
+  {
+    if (rhs._ops)
+    {
+      rhs._ops->copy(rhs._buf, _buf);
+      _ops = rhs._ops;
+    }
+  }
+
+  Function(Function&& rhs) noexcept
+  {
+    if (rhs._ops)
+    {
+      rhs._ops->move(rhs._buf, _buf);
+      _ops = rhs._ops;
+      rhs._ops = nullptr;
+    }
+  }
+
+  ~Function()
+  {
+    reset();
+  }
+
+  Function& operator=(Function rhs) noexcept
+  {
+    reset();
+
+    if (rhs._ops)
+    {
+      rhs._ops->move(rhs._buf, _buf);
+      _ops = rhs._ops;
+      rhs._ops = nullptr;
+    }
+
+    return *this;
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return _ops != nullptr;
+  }
+
+  R operator()(Args... args) const
+  {
+    if (! _ops)
+    {
+      throw std::bad_function_call();
+    }
+
+    return _ops->invoke(const_cast<unsigned char*>(_buf), std::forward<Args>(args)...);
+  }
+
+  void reset() noexcept
+  {
+    if (_ops)
+    {
+      _ops->destroy(_buf);
+      _ops = nullptr;
+    }
+  }
+
+private:
+
+  struct Ops
+  {
+    R (*invoke)(void*, Args&&...);
+    void (*copy)(void const*, void*);
+    void (*move)(void*, void*);
+    void (*destroy)(void*);
+  }; // struct Ops
+
+  template<typename T>
+  static constexpr bool is_inline {sizeof(T) <= Size &&
+    alignof(T) <= alignof(std::max_align_t) &&
+    std::is_nothrow_move_constructible_v<T>};
+
+  template<typename T>
+  static R call(T& fn, Args&&... args)
+  {
+    if constexpr (std::is_void_v<R>)
+    {
+      std::invoke(fn, std::forward<Args>(args)...);
+    }
+    else
+    {
+      return std::invoke(fn, std::forward<Args>(args)...);
+    }
+  }
+
+  // callable stored in the buffer
+  template<typename T>
+  struct Inline
+  {
+    static T* get(void* buf)
+    {
+      return std::launder(static_cast<T*>(buf));
+    }
+
+    static R invoke(void* buf, Args&&... args)
+    {
+      return call(*get(buf), std::forward<Args>(args)...);
+    }
+
+    static void copy(void const* src, void* dst)
+    {
+      ::new (dst) T(*std::launder(static_cast<T const*>(src)));
+    }
+
+    static void move(void* src, void* dst)
+    {
+      ::new (dst) T(std::move(*get(src)));
+      get(src)->~T();
+    }
+
+    static void destroy(void* buf)
+    {
+      get(buf)->~T();
+    }
+
+    static constexpr Ops ops {&invoke, &copy, &move, &destroy};
+  }; // struct Inline
+
+  // callable stored on the heap, the buffer holds the pointer
+  template<typename T>
+  struct Heap
+  {
+    static T* get(void const* buf)
+    {
+      return *std::launder(static_cast<T* const*>(buf));
+    }
+
+    static R invoke(void* buf, Args&&... args)
+    {
+      return call(*get(buf), std::forward<Args>(args)...);
+    }
+
+    static void copy(void const* src, void* dst)
+    {
+      ::new (dst) T*(new T(*get(src)));
+    }
+
+    static void move(void* src, void* dst)
+    {
+      ::new (dst) T*(get(src));
+    }
+
+    static void destroy(void* buf)
+    {
+      delete get(buf);
+    }
+
+    static constexpr Ops ops {&invoke, &copy, &move, &destroy};
+  }; // struct Heap
+
+  alignas(std::max_align_t) unsigned char _buf[Size];
+  Ops const* _ops {nullptr};
+}; // class Function
+
+// Cache_Stats: counters reported by a cache
+struct Cache_Stats
+{
+  // lookups that found an entry
+  std::uint64_t hits {0};
+
+  // lookups that did not find an entry
+  std::uint64_t misses {0};
+
+  // number of entries
+  std::size_t size {0};
+}; // struct Cache_Stats
+
+// Lru_Cache: a bounded least recently used cache, safe to use from multiple threads
+// keys are spread over independently locked shards to reduce contention
+// each entry has a cost, the capacity limits the total cost
+template<typename K, typename V, typename Hash = std::hash<K>>
+class Lru_Cache
+{
+public:
+
+  Lru_Cache(std::size_t capacity = 0, std::size_t cost_max = 1)
+  {
+    this->capacity(capacity, cost_max);
+  }
+
+  ~Lru_Cache()
+  {
+  }
+
+  // set the capacity, clears the cache
+  // the number of shards is limited so that each shard can hold an entry of cost_max
+  Lru_Cache& capacity(std::size_t capacity, std::size_t cost_max = 1)
+  {
+    _capacity = capacity;
+    _shards.clear();
+
+    auto const shards = std::min(shards_max,
+      std::max<std::size_t>(1, capacity / std::max<std::size_t>(1, cost_max)));
+
+    for (std::size_t i = 0; i < shards; ++i)
+    {
+      _shards.emplace_back(std::make_unique<Shard>());
+    }
+
+    _shard_capacity = (capacity + shards - 1) / shards;
+
+    return *this;
+  }
+
+  // get the capacity
+  std::size_t capacity() const
+  {
+    return _capacity;
+  }
+
+  // find an entry and mark it as the most recently used
+  std::optional<V> find(K const& key)
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock {shard.mtx};
+
+    auto const it = shard.map.find(key);
+
+    if (it == shard.map.end())
+    {
+      _misses.fetch_add(1, std::memory_order_relaxed);
+
+      return {};
+    }
+
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    _hits.fetch_add(1, std::memory_order_relaxed);
+
+    return it->second->value;
+  }
+
+  // insert or replace an entry, evicting the least recently used entries
+  Lru_Cache& insert(K const& key, V value, std::size_t cost = 1)
+  {
+    if (cost > _shard_capacity)
+    {
+      return *this;
+    }
+
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock {shard.mtx};
+
+    auto const it = shard.map.find(key);
+
+    if (it != shard.map.end())
+    {
+      shard.cost -= it->second->cost;
+      shard.lru.erase(it->second);
+      shard.map.erase(it);
+    }
+
+    shard.lru.emplace_front(Entry {key, std::move(value), cost});
+    shard.map.emplace(key, shard.lru.begin());
+    shard.cost += cost;
+
+    while (shard.cost > _shard_capacity)
+    {
+      auto& last = shard.lru.back();
+      shard.cost -= last.cost;
+      shard.map.erase(last.key);
+      shard.lru.pop_back();
+    }
+
+    return *this;
+  }
+
+  // remove an entry
+  Lru_Cache& erase(K const& key)
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock {shard.mtx};
+
+    auto const it = shard.map.find(key);
+
+    if (it != shard.map.end())
+    {
+      shard.cost -= it->second->cost;
+      shard.lru.erase(it->second);
+      shard.map.erase(it);
+    }
+
+    return *this;
+  }
+
+  // remove all entries
+  Lru_Cache& clear()
+  {
+    for (auto& e : _shards)
+    {
+      std::lock_guard<std::mutex> lock {e->mtx};
+      e->lru.clear();
+      e->map.clear();
+      e->cost = 0;
+    }
+
+    return *this;
+  }
+
+  // get the counters
+  Cache_Stats stats() const
+  {
+    Cache_Stats res;
+    res.hits = _hits.load(std::memory_order_relaxed);
+    res.misses = _misses.load(std::memory_order_relaxed);
+
+    for (auto const& e : _shards)
+    {
+      std::lock_guard<std::mutex> lock {e->mtx};
+      res.size += e->lru.size();
+    }
+
+    return res;
+  }
+
+private:
+
+  static constexpr std::size_t shards_max {16};
+
+  struct Entry
+  {
+    K key;
+    V value;
+    std::size_t cost;
+  }; // struct Entry
+
+  struct Shard
+  {
+    mutable std::mutex mtx {};
+    std::list<Entry> lru {};
+    std::unordered_map<K, typename std::list<Entry>::iterator, Hash> map {};
+    std::size_t cost {0};
+  }; // struct Shard
+
+  Shard& shard(K const& key)
+  {
+    return *_shards[Hash {}(key) % _shards.size()];
+  }
+
+  std::size_t _capacity {0};
+  std::size_t _shard_capacity {0};
+  std::vector<std::unique_ptr<Shard>> _shards {};
+  std::atomic<std::uint64_t> _hits {0};
+  std::atomic<std::uint64_t> _misses {0};
+}; // class Lru_Cache
+
+// fnv-1a hash of a string, usable at compile time
+constexpr std::uint64_t hash(std::string_view str)
+{
+  std::uint64_t res {0xcbf29ce484222325};
+
+  for (std::size_t i = 0; i < str.size(); ++i)
+  {
+    res ^= static_cast<unsigned char>(str[i]);
+    res *= 0x100000001b3;
+  }
+
+  return res;
+}
+
+// Router: matches a request path against insert ordered routes
+// literal and ':param' routes are stored in a prefix tree of path segments,
+// resolved in a single pass over the path
+// all other routes are regexes, tried in insert order as the fallback
+// the first inserted route that matches the path and predicate wins
+template<typename T>
+class Router
+{
+public:
+
+  struct Match
+  {
+    // the matched route value
+    T value {};
+
+    // index 0 is the full path, index 1 to n are the captures
+    std::vector<std::string_view> captures {};
+
+    // routes matching the path but not the predicate, set if no route matched
+    std::vector<T> rejected {};
+  }; // struct Match
+
+  Router()
+  {
+  }
+
+  ~Router()
+  {
+  }
+
+  // add a route with its compiled regex
+  // the regex is only used if the route can't be stored in the tree
+  Router& add(std::string const& route, std::regex const& rx, T const& value)
+  {
+    auto const index = _size++;
+
+    std::vector<std::string> segments;
+
+    if (! tree_segments(route, segments))
+    {
+      _regex.emplace_back(Regex_Entry {value, index, &rx});
+
+      return *this;
+    }
+
+    Node* node {&_root};
+
+    for (auto const& e : segments)
+    {
+      if (e.size() > 1 && e.front() == ':')
+      {
+        if (! node->param)
+        {
+          node->param = std::make_unique<Node>();
+        }
+
+        node = node->param.get();
+      }
+      else
+      {
+        auto it = node->children.find(e);
+
+        if (it == node->children.end())
+        {
+          auto child = std::make_unique<Node>();
+          child->segment = e;
+          std::string_view const key {child->segment};
+          it = node->children.emplace(key, std::move(child)).first;
+        }
+
+        node = it->second.get();
+      }
+    }
+
+    node->entries.emplace_back(Entry {value, index});
+
+    return *this;
+  }
+
+  // find the first inserted route matching the path and predicate
+  template<typename Fn>
+  bool find(std::string_view path, Fn const& pred, Match& match) const
+  {
+    match.captures.clear();
+    match.rejected.clear();
+
+    if (path.empty() || path.front() != '/')
+    {
+      return false;
+    }
+
+    // the best tree match
+    Entry const* best {nullptr};
+    std::vector<std::string_view> captures;
+    std::vector<std::string_view> best_captures;
+    walk(_root, path.substr(1), false, pred, captures, best, best_captures,
+      match.rejected);
+
+    // regex routes inserted before the tree match take precedence
+    std::regex_constants::match_flag_type const rx_flgs {std::regex_constants::match_not_null};
+    std::cmatch rx_match {};
+
+    for (auto const& e : _regex)
+    {
+      if (best && e.index > best->index)
+      {
+        break;
+      }
+
+      if (! pred(e.value))
+      {
+        continue;
+      }
+
+      if (std::regex_match(path.data(), path.data() + path.size(),
+        rx_match, *e.rx, rx_flgs))
+      {
+        match.value = e.value;
+
+        for (auto const& m : rx_match)
+        {
+          match.captures.emplace_back(m.first,
+            static_cast<std::size_t>(m.length()));
+        }
+
+        return true;
+      }
+    }
+
+    if (! best)
+    {
+      // regex routes matching the path but not the predicate,
+      // only checked once no route has matched
+      for (auto const& e : _regex)
+      {
+        if (! pred(e.value) &&
+          std::regex_match(path.data(), path.data() + path.size(), *e.rx, rx_flgs))
+        {
+          match.rejected.emplace_back(e.value);
+        }
+      }
+
+      return false;
+    }
+
+    match.value = best->value;
+    match.captures.emplace_back(path);
+    match.captures.insert(match.captures.end(),
+      best_captures.begin(), best_captures.end());
+
+    return true;
+  }
+
+  std::size_t size() const
+  {
+    return _size;
+  }
+
+  bool empty() const
+  {
+    return _size == 0;
+  }
+
+  Router& clear()
+  {
+    _root = Node();
+    _regex.clear();
+    _size = 0;
+
+    return *this;
+  }
+
+private:
+
+  struct Entry
+  {
+    T value;
+    std::size_t index;
+  }; // struct Entry
+
+  struct Regex_Entry
+  {
+    T value;
+    std::size_t index;
+    std::regex const* rx;
+  }; // struct Regex_Entry
+
+  struct Node
+  {
+    // the literal segment, owns the key in the parent's children
+    std::string segment {};
+
+    // literal segment children
+    std::unordered_map<std::string_view, std::unique_ptr<Node>> children {};
+
+    // ':param' segment child
+    std::unique_ptr<Node> param {};
+
+    // routes ending at this node in insert order
+    std::vector<Entry> entries {};
+  }; // struct Node
+
+  // split a route into segments if it is a literal or ':param' route
+  static bool tree_segments(std::string const& route, std::vector<std::string>& segments)
+  {
+    std::string_view str {route};
+
+    // regex_match always matches the full path, anchors are redundant
+    if (! str.empty() && str.front() == '^')
+    {
+      str.remove_prefix(1);
+    }
+
+    if (! str.empty() && str.back() == '$')
+    {
+      str.remove_suffix(1);
+    }
+
+    if (str.empty() || str.front() != '/' ||
+      str.find_first_of("\\^$.|?*+()[]{}") != std::string_view::npos)
+    {
+      return false;
+    }
+
+    str.remove_prefix(1);
+
+    for (;;)
+    {
+      auto const pos = str.find('/');
+      auto const seg = str.substr(0, pos);
+
+      if (seg.size() > 1 && seg.front() == ':')
+      {
+        for (auto const c : seg.substr(1))
+        {
+          if (! (std::isalnum(static_cast<unsigned char>(c)) || c == '_'))
+          {
+            return false;
+          }
+        }
+      }
+
+      segments.emplace_back(seg);
+
+      if (pos == std::string_view::npos)
+      {
+        break;
+      }
+
+      str.remove_prefix(pos + 1);
+    }
+
+    return true;
+  }
+
+  // depth first search for the lowest index entry matching the path
+  template<typename Fn>
+  static void walk(Node const& node, std::string_view rest, bool done, Fn const& pred,
+    std::vector<std::string_view>& captures, Entry const*& best,
+    std::vector<std::string_view>& best_captures, std::vector<T>& rejected)
+  {
+    if (done)
+    {
+      for (auto const& e : node.entries)
+      {
+        if (best && e.index > best->index)
+        {
+          break;
+        }
+
+        if (pred(e.value))
+        {
+          best = &e;
+          best_captures = captures;
+          break;
+        }
+
+        rejected.emplace_back(e.value);
+      }
+
+      return;
+    }
+
+    auto const pos = rest.find('/');
+    auto const seg = rest.substr(0, pos);
+    bool const last {pos == std::string_view::npos};
+    auto const next = last ? std::string_view() : rest.substr(pos + 1);
+
+    auto const it = node.children.find(seg);
+
+    if (it != node.children.end())
+    {
+      walk(*it->second, next, last, pred, captures, best, best_captures, rejected);
+    }
+
+    if (node.param && ! seg.empty())
+    {
+      captures.emplace_back(seg);
+      walk(*node.param, next, last, pred, captures, best, best_captures, rejected);
+      captures.pop_back();
+    }
+  }
+
+  Node _root {};
+  std::vector<Regex_Entry> _regex {};
+  std::size_t _size {0};
+}; // class Router
+
+#ifdef BOOST_HAS_UNISTD_H
+
+// Open_File: a read only descriptor of a regular file and its status
+// reads are positional, so the file can be shared by concurrent responses
+// the descriptor is closed on destruction
+class Open_File
+{
+public:
+
+  // open a file, is_open is false if it is missing or not a regular file
+  explicit Open_File(std::string const& path)
+  {
+    _fd = ::open(path.data(), O_RDONLY | O_CLOEXEC);
+
+    if (_fd == -1)
+    {
+      return;
+    }
+
+    if (::fstat(_fd, &_stat) != 0 || (_stat.st_mode & S_IFMT) != S_IFREG)
+    {
+      ::close(_fd);
+      _fd = -1;
+    }
+  }
+
+  Open_File(Open_File const&) = delete;
+  Open_File& operator=(Open_File const&) = delete;
+
+  ~Open_File()
+  {
+    if (_map)
+    {
+      ::munmap(_map, static_cast<std::size_t>(this->size()));
+    }
+
+    if (_fd != -1)
+    {
+      ::close(_fd);
+    }
+  }
+
+  bool is_open() const
+  {
+    return _fd != -1;
+  }
+
+  int native_handle() const
+  {
+    return _fd;
+  }
+
+  struct stat const& status() const
+  {
+    return _stat;
+  }
+
+  std::uint64_t size() const
+  {
+    return static_cast<std::uint64_t>(_stat.st_size);
+  }
+
+  // map the file read only on first use, shared by every user of the file
+  // returns a null view if the file is empty or can not be mapped
+  std::string_view map() const
+  {
+    std::call_once(_map_once, [this]() noexcept
+    {
+      auto const size = static_cast<std::size_t>(this->size());
+
+      if (size == 0)
+      {
+        return;
+      }
+
+      auto const ptr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, _fd, 0);
+
+      if (ptr == MAP_FAILED)
+      {
+        return;
+      }
+
+      ::madvise(ptr, size, MADV_SEQUENTIAL);
+      _map = ptr;
+    });
+
+    if (! _map)
+    {
+      return {};
+    }
+
+    return {static_cast<char const*>(_map), static_cast<std::size_t>(this->size())};
+  }
+
+  // read up to size bytes at an offset, returns 0 at the end of the file
+  std::size_t read(std::uint64_t offset, char* buf, std::size_t size, error_code& ec) const
+  {
+    for (;;)
+    {
+      auto const bytes = ::pread(_fd, buf, size, static_cast<off_t>(offset));
+
+      if (bytes >= 0)
+      {
+        ec = {};
+
+        return static_cast<std::size_t>(bytes);
+      }
+
+      if (errno != EINTR)
+      {
+        ec.assign(errno, boost::system::system_category());
+
+        return 0;
+      }
+    }
+  }
+
+private:
+
+  int _fd {-1};
+  struct stat _stat {};
+  mutable std::once_flag _map_once {};
+  mutable void* _map {nullptr};
+}; // class Open_File
+
+#else
+
+// Open_File: a read only beast file of a regular file and its status
+// used where posix file descriptors are not available,
+// reads seek under a lock so the file can be shared by concurrent responses,
+// the file is never memory mapped
+class Open_File
+{
+public:
+
+  // open a file, is_open is false if it is missing or not a regular file
+  explicit Open_File(std::string const& path)
+  {
+    if (::stat(path.data(), &_stat) != 0 || (_stat.st_mode & S_IFMT) != S_IFREG)
+    {
+      return;
+    }
+
+    error_code ec;
+    _file.open(path.data(), boost::beast::file_mode::read, ec);
+  }
+
+  Open_File(Open_File const&) = delete;
+  Open_File& operator=(Open_File const&) = delete;
+
+  bool is_open() const
+  {
+    return _file.is_open();
+  }
+
+  struct stat const& status() const
+  {
+    return _stat;
+  }
+
+  std::uint64_t size() const
+  {
+    return static_cast<std::uint64_t>(_stat.st_size);
+  }
+
+  // memory mapping is not supported, always returns a null view
+  std::string_view map() const
+  {
+    return {};
+  }
+
+  // read up to size bytes at an offset, returns 0 at the end of the file
+  std::size_t read(std::uint64_t offset, char* buf, std::size_t size, error_code& ec) const
+  {
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    _file.seek(offset, ec);
+
+    if (ec)
+    {
+      return 0;
+    }
+
+    return _file.read(buf, size, ec);
+  }
+
+private:
+
+  struct stat _stat {};
+  mutable std::mutex _mutex {};
+  mutable boost::beast::file _file {};
+}; // class Open_File
+
+#endif // BOOST_HAS_UNISTD_H
+
+// Shared_Body: an http body holding a view of shared immutable memory
+// such as a cached buffer or a file mapping, kept alive by its owner
+// the memory is written directly without copying it into the message
+struct Shared_Body
+{
+  struct value_type
+  {
+    std::shared_ptr<void const> owner {};
+    std::string_view data {};
+  }; // struct value_type
+
+  static std::uint64_t size(value_type const& body)
+  {
+    return body.data.size();
+  }
+
+  class writer
+  {
+  public:
+
+    using const_buffers_type = net::const_buffer;
+
+    template<bool isRequest, typename Fields>
+    explicit writer(http::header<isRequest, Fields> const&, value_type const& body) :
+      _body {body}
+    {
+    }
+
+    void init(error_code& ec)
+    {
+      ec = {};
+    }
+
+    boost::optional<std::pair<const_buffers_type, bool>> get(error_code& ec)
+    {
+      ec = {};
+
+      if (_body.data.empty())
+      {
+        return boost::none;
+      }
+
+      return {{const_buffers_type {_body.data.data(), _body.data.size()}, false}};
+    }
+
+  private:
+
+    value_type const& _body;
+  }; // class writer
+}; // struct Shared_Body
+
+// File_Body: an http body holding a shared open file, read in blocks of Size bytes
+// the default size matches the largest tls record, so over ssl each block
+// is encrypted and written as a single full record
+template<std::size_t Size = 16384>
+struct File_Body
+{
+  using value_type = std::shared_ptr<Open_File const>;
+
+  static std::uint64_t size(value_type const& body)
+  {
+    return body ? body->size() : 0;
+  }
+
+  class writer
+  {
+  public:
+
+    using const_buffers_type = net::const_buffer;
+
+    template<bool isRequest, typename Fields>
+    explicit writer(http::header<isRequest, Fields>&, value_type& body) :
+      _body {body},
+      _remain {size(body)}
+    {
+    }
+
+    void init(error_code& ec)
+    {
+      ec = {};
+    }
+
+    boost::optional<std::pair<const_buffers_type, bool>> get(error_code& ec)
+    {
+      ec = {};
+
+      auto const amount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(_remain, Size));
+
+      if (amount == 0)
+      {
+        return boost::none;
+      }
+
+      auto const bytes = _body->read(_pos, _buf.data(), amount, ec);
+
+      if (ec)
+      {
+        return boost::none;
+      }
+
+      if (bytes == 0)
+      {
+        // the file was truncated
+        ec = net::error::eof;
+
+        return boost::none;
+      }
+
+      _pos += bytes;
+      _remain -= bytes;
+
+      return {{const_buffers_type {_buf.data(), bytes}, _remain > 0}};
+    }
+
+  private:
+
+    value_type& _body;
+    std::uint64_t _remain;
+    std::uint64_t _pos {0};
+    std::array<char, Size> _buf;
+  }; // class writer
+}; // struct File_Body
+
+// Range_Body: an http body holding byte ranges of a file or of shared memory
+// each range is preceded by a head, used for the part headers of a multipart response
+// file ranges are read in blocks of 16KB, memory ranges are written without copying
+struct Range_Body
+{
+  struct Part
+  {
+    // written before the range
+    std::string head {};
+
+    // the range in the file
+    std::uint64_t offset {0};
+    std::uint64_t size {0};
+  }; // struct Part
+
+  struct value_type
+  {
+    // the file to read from if the contents are not set
+    std::shared_ptr<Open_File const> file {};
+
+    // the file contents if held in memory or mapped
+    Shared_Body::value_type contents {};
+
+    // the ranges to write
+    std::vector<Part> parts {};
+
+    // written after the last range
+    std::string tail {};
+
+    std::uint64_t size() const
+    {
+      std::uint64_t res {tail.size()};
+
+      for (auto const& e : parts)
+      {
+        res += e.head.size() + e.size;
+      }
+
+      return res;
+    }
+  }; // struct value_type
+
+  static std::uint64_t size(value_type const& body)
+  {
+    return body.size();
+  }
+
+  class writer
+  {
+  public:
+
+    using const_buffers_type = net::const_buffer;
+
+    template<bool isRequest, typename Fields>
+    explicit writer(http::header<isRequest, Fields>&, value_type& body) :
+      _body {body},
+      _remain {body.size()}
+    {
+    }
+
+    void init(error_code& ec)
+    {
+      ec = {};
+    }
+
+    boost::optional<std::pair<const_buffers_type, bool>> get(error_code& ec)
+    {
+      ec = {};
+
+      while (_part < _body.parts.size())
+      {
+        auto const& part = _body.parts[_part];
+
+        if (! _head)
+        {
+          _head = true;
+          _pos = 0;
+
+          if (! part.head.empty())
+          {
+            return next({part.head.data(), part.head.size()});
+          }
+        }
+
+        if (_pos == part.size)
+        {
+          ++_part;
+          _head = false;
+          continue;
+        }
+
+        auto const amount = static_cast<std::size_t>(
+          std::min<std::uint64_t>(part.size - _pos, _buf.size()));
+
+        if (_body.contents.data.data())
+        {
+          auto const data = _body.contents.data.data() + part.offset + _pos;
+          _pos += amount;
+
+          return next({data, amount});
+        }
+
+        auto const bytes = _body.file->read(part.offset + _pos, _buf.data(), amount, ec);
+
+        if (ec)
+        {
+          return boost::none;
+        }
+
+        if (bytes == 0)
+        {
+          // the file was truncated
+          ec = net::error::eof;
+
+          return boost::none;
+        }
+
+        _pos += bytes;
+
+        return next({_buf.data(), bytes});
+      }
+
+      if (! _tail && ! _body.tail.empty())
+      {
+        _tail = true;
+
+        return next({_body.tail.data(), _body.tail.size()});
+      }
+
+      return boost::none;
+    }
+
+  private:
+
+    std::pair<const_buffers_type, bool> next(const_buffers_type buf)
+    {
+      _remain -= buf.size();
+
+      return {buf, _remain > 0};
+    }
+
+    value_type& _body;
+    std::uint64_t _remain;
+    std::size_t _part {0};
+    std::uint64_t _pos {0};
+    bool _head {false};
+    bool _tail {false};
+    std::array<char, 16384> _buf;
+  }; // class writer
+}; // struct Range_Body
+
+#ifdef __linux__
+// Dir_Watch: watches a directory tree with inotify on an io_context
+// calls the callback with the path of each changed file,
+// or with an empty path if any file in the tree may have changed
+class Dir_Watch
+{
+public:
+
+  using fn_on_change = Function<void(std::string const&)>;
+
+  Dir_Watch(net::io_context& io_) :
+    _stream {io_}
+  {
+  }
+
+  ~Dir_Watch()
+  {
+  }
+
+  // start watching a directory and its subdirectories
+  // returns false if inotify is unavailable
+  bool watch(std::string const& dir_, fn_on_change on_change_)
+  {
+    this->cancel();
+
+    auto const fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (fd == -1)
+    {
+      return false;
+    }
+
+    error_code ec;
+    _stream.assign(fd, ec);
+
+    if (ec)
+    {
+      ::close(fd);
+
+      return false;
+    }
+
+    _on_change = std::move(on_change_);
+    this->add(dir_, true);
+    this->do_read();
+
+    return true;
+  }
+
+  // stop watching
+  void cancel()
+  {
+    error_code ec;
+    _stream.close(ec);
+    _dirs.clear();
+  }
+
+private:
+
+  static constexpr std::uint32_t events {IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB |
+    IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF};
+
+  // watch a directory and its subdirectories
+  // symlinks are not followed below the root, so a link loop can't recurse
+  void add(std::string const& dir_, bool root_ = false)
+  {
+    auto const wd = ::inotify_add_watch(_stream.native_handle(), dir_.data(),
+      events | IN_ONLYDIR | (root_ ? 0u : static_cast<std::uint32_t>(IN_DONT_FOLLOW)));
+
+    if (wd == -1)
+    {
+      return;
+    }
+
+    _dirs[wd] = dir_;
+
+    auto const dir = ::opendir(dir_.data());
+
+    if (! dir)
+    {
+      return;
+    }
+
+    while (auto const ent = ::readdir(dir))
+    {
+      std::string_view const name {ent->d_name};
+
+      if (name == "." || name == "..")
+      {
+        continue;
+      }
+
+      auto const path = dir_ + "/" + ent->d_name;
+      struct stat st;
+
+      if (ent->d_type == DT_DIR || (ent->d_type == DT_UNKNOWN &&
+        ::lstat(path.data(), &st) == 0 && (st.st_mode & S_IFMT) == S_IFDIR))
+      {
+        this->add(path);
+      }
+    }
+
+    ::closedir(dir);
+  }
+
+  // stop watching a directory and its subdirectories
+  void remove(std::string const& dir_)
+  {
+    for (auto it = _dirs.begin(); it != _dirs.end();)
+    {
+      if (it->second == dir_ || it->second.compare(0, dir_.size() + 1, dir_ + "/") == 0)
+      {
+        ::inotify_rm_watch(_stream.native_handle(), it->first);
+        it = _dirs.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
+  void do_read()
+  {
+    _stream.async_read_some(net::buffer(_buf),
+      [this](error_code ec, std::size_t bytes)
+      {
+        if (ec)
+        {
+          return;
+        }
+
+        this->on_read(bytes);
+        this->do_read();
+      }
+    );
+  }
+
+  void on_read(std::size_t bytes_)
+  {
+    for (std::size_t pos = 0; pos + sizeof(inotify_event) <= bytes_;)
+    {
+      inotify_event event;
+      std::memcpy(&event, _buf.data() + pos, sizeof(inotify_event));
+      std::string const name {_buf.data() + pos + sizeof(inotify_event),
+        ::strnlen(_buf.data() + pos + sizeof(inotify_event), event.len)};
+      pos += sizeof(inotify_event) + event.len;
+
+      // events were dropped
+      if (event.mask & IN_Q_OVERFLOW)
+      {
+        _on_change({});
+        continue;
+      }
+
+      auto const it = _dirs.find(event.wd);
+
+      if (it == _dirs.end())
+      {
+        continue;
+      }
+
+      if (event.mask & IN_IGNORED)
+      {
+        _dirs.erase(it);
+        continue;
+      }
+
+      // the watched directory itself was deleted or moved
+      if (name.empty())
+      {
+        _on_change({});
+        continue;
+      }
+
+      auto const path = it->second + "/" + name;
+
+      // a subdirectory was added, removed, or renamed
+      if (event.mask & IN_ISDIR)
+      {
+        if (event.mask & (IN_DELETE | IN_MOVED_FROM))
+        {
+          this->remove(path);
+        }
+
+        if (event.mask & (IN_CREATE | IN_MOVED_TO))
+        {
+          this->add(path);
+        }
+
+        _on_change({});
+        continue;
+      }
+
+      _on_change(path);
+    }
+  }
+
+  net::posix::stream_descriptor _stream;
+  std::unordered_map<int, std::string> _dirs {};
+  fn_on_change _on_change {};
+  alignas(inotify_event) std::array<char, 4096> _buf;
+}; // class Dir_Watch
+#endif // __linux__
+
+#ifdef OB_BELLE_CONFIG_SSL_ON
+// TODO switch to boost::beast::ssl_stream when it moves out of experimental
+template<typename Next_Layer>
+class ssl_stream : public ssl::stream_base
+{
+// This class (ssl_stream) is a derivative work based on Boost.Beast,
+// orignal copyright below:
+/*
+  Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+
+  Boost Software License - Version 1.0 - August 17th, 2003
+
+  Permission is hereby granted, free of charge, to any person or organization
+  obtaining a copy of the software and accompanying documentation covered by
+  this license (the "Software") to use, reproduce, display, distribute,
+  execute, and transmit the Software, and to prepare derivative works of the
+  Software, and to permit third-parties to whom the Software is furnished to
+  do so, all subject to the following:
+
+  The copyright notices in the Software and this entire statement, including
+  the above license grant, this restriction and the following disclaimer,
+  must be included in all copies of the Software, in whole or in part, and
+  all derivative works of the Software, unless such copies or derivative
+  works are solely in the form of machine-executable object code generated by
+  a source language processor.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+  SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+  FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+  DEALINGS IN THE SOFTWARE.
+*/
+
+  using stream_type = ssl::stream<Next_Layer>;
+
+public:
+
+  using native_handle_type = typename stream_type::native_handle_type;
+  using impl_struct = typename stream_type::impl_struct;
+  using next_layer_type = typename stream_type::next_layer_type;
+  using lowest_layer_type = typename stream_type::lowest_layer_type;
+  using executor_type = typename stream_type::executor_type;
+
+  ssl_stream(Next_Layer&& arg, ssl::context& ctx) :
+    _ptr {std::make_unique<stream_type>(std::move(arg), ctx)}
+  {
+  }
+
+  executor_type get_executor() noexcept
+  {
+    return _ptr->get_executor();
+  }
+
+  native_handle_type native_handle()
+  {
+    return _ptr->native_handle();
+  }
+
+  next_layer_type const& next_layer() const
+  {
+    return _ptr->next_layer();
+  }
+
+  next_layer_type& next_layer()
+  {
+    return _ptr->next_layer();
+  }
+
+  lowest_layer_type& lowest_layer()
+  {
+    return _ptr->lowest_layer();
+  }
+
+  lowest_layer_type const& lowest_layer() const
+  {
+    return _ptr->lowest_layer();
+  }
+
+  void set_verify_mode(ssl::verify_mode v)
+  {
+    _ptr->set_verify_mode(v);
+  }
+
+  void set_verify_mode(ssl::verify_mode v, error_code& ec)
+  {
+    _ptr->set_verify_mode(v, ec);
+  }
+
+  void set_verify_depth(int depth)
+  {
+    _ptr->set_verify_depth(depth);
+  }
+
+  void set_verify_depth(int depth, error_code& ec)
+  {
+    _ptr->set_verify_depth(depth, ec);
+  }
+
+  template<typename VerifyCallback>
+  void set_verify_callback(VerifyCallback callback)
+  {
+    _ptr->set_verify_callback(callback);
+  }
+
+  template<typename VerifyCallback>
+  void set_verify_callback(VerifyCallback callback, error_code& ec)
+  {
+    _ptr->set_verify_callback(callback, ec);
+  }
+
+  void handshake(handshake_type type)
+  {
+    _ptr->handshake(type);
+  }
+
+  void handshake(handshake_type type, error_code& ec)
+  {
+    _ptr->handshake(type, ec);
+  }
+
+  template<typename ConstBufferSequence>
+  void handshake(handshake_type type, ConstBufferSequence const& buffers)
+  {
+    _ptr->handshake(type, buffers);
+  }
+
+  template<typename ConstBufferSequence>
+  void handshake(handshake_type type, ConstBufferSequence const& buffers, error_code& ec)
+  {
+    _ptr->handshake(type, buffers, ec);
+  }
+
+  template<typename HandshakeHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(HandshakeHandler, void(error_code))
+  async_handshake(handshake_type type, BOOST_ASIO_MOVE_ARG(HandshakeHandler) handler)
+  {
+    return _ptr->async_handshake(type, BOOST_ASIO_MOVE_CAST(HandshakeHandler)(handler));
+  }
+
+  template<typename ConstBufferSequence, typename BufferedHandshakeHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(BufferedHandshakeHandler, void (error_code, std::size_t))
+  async_handshake(handshake_type type, ConstBufferSequence const& buffers,
+    BOOST_ASIO_MOVE_ARG(BufferedHandshakeHandler) handler)
+  {
+    return _ptr->async_handshake(type, buffers, BOOST_ASIO_MOVE_CAST(BufferedHandshakeHandler)(handler));
+  }
+
+  void shutdown()
+  {
+    _ptr->shutdown();
+  }
+
+  void shutdown(error_code& ec)
+  {
+    _ptr->shutdown(ec);
+  }
+
+  template<typename ShutdownHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(ShutdownHandler, void (error_code))
+  async_shutdown(BOOST_ASIO_MOVE_ARG(ShutdownHandler) handler)
+  {
+    return _ptr->async_shutdown(BOOST_ASIO_MOVE_CAST(ShutdownHandler)(handler));
+  }
+
+  template<typename ConstBufferSequence>
+  std::size_t write_some(ConstBufferSequence const& buffers)
+  {
+    return _ptr->write_some(buffers);
+  }
+
+  template<typename ConstBufferSequence>
+  std::size_t write_some(ConstBufferSequence const& buffers, error_code& ec)
+  {
+    return _ptr->write_some(buffers, ec);
+  }
+
+  template<typename ConstBufferSequence, typename WriteHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(WriteHandler, void (error_code, std::size_t))
+  async_write_some(ConstBufferSequence const& buffers,
+    BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
+  {
+    return _ptr->async_write_some(buffers, BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+  }
+
+  template<typename MutableBufferSequence>
+  std::size_t read_some(MutableBufferSequence const& buffers)
+  {
+    return _ptr->read_some(buffers);
+  }
+
+  template<typename MutableBufferSequence>
+  std::size_t read_some(MutableBufferSequence const& buffers, error_code& ec)
+  {
+    return _ptr->read_some(buffers, ec);
+  }
+
+  template<typename MutableBufferSequence, typename ReadHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(ReadHandler, void(error_code, std::size_t))
+  async_read_some(MutableBufferSequence const& buffers,
+    BOOST_ASIO_MOVE_ARG(ReadHandler) handler)
+  {
+    return _ptr->async_read_some(buffers, BOOST_ASIO_MOVE_CAST(ReadHandler)(handler));
+  }
+
+  template<typename SyncStream>
+  friend void teardown(websocket::role_type,
+    ssl_stream<SyncStream>& stream, error_code& ec);
+
+  template<typename AsyncStream, typename TeardownHandler>
+  friend void async_teardown(websocket::role_type,
+    ssl_stream<AsyncStream>& stream, TeardownHandler&& handler);
+
+private:
+
+  std::unique_ptr<stream_type> _ptr;
+}; // class ssl_stream
+
+template<typename SyncStream>
+inline void teardown(websocket::role_type role,
+  ssl_stream<SyncStream>& stream, error_code& ec)
+{
+  websocket::teardown(role, *stream._ptr, ec);
+}
+
+template<typename AsyncStream, typename TeardownHandler>
+inline void async_teardown(websocket::role_type role,
+  ssl_stream<AsyncStream>& stream, TeardownHandler&& handler)
+{
+  websocket::async_teardown(role, *stream._ptr, std::forward<TeardownHandler>(handler));
+}
+#endif // OB_BELLE_CONFIG_SSL_ON
+
+// built in mime types by lowercase file extension
+inline constexpr std::array<std::pair<std::string_view, std::string_view>, 103> mime_builtin
+{{
+  {"html", "text/html"},
+  {"htm", "text/html"},
+  {"shtml", "text/html"},
+  {"css", "text/css"},
+  {"xml", "text/xml"},
+  {"gif", "image/gif"},
+  {"jpg", "image/jpg"},
+  {"jpeg", "image/jpg"},
+  {"js", "application/javascript"},
+  {"atom", "application/atom+xml"},
+  {"rss", "application/rss+xml"},
+  {"mml", "text/mathml"},
+  {"txt", "text/plain"},
+  {"jad", "text/vnd.sun.j2me.app-descriptor"},
+  {"wml", "text/vnd.wap.wml"},
+  {"htc", "text/x-component"},
+  {"png", "image/png"},
+  {"tif", "image/tiff"},
+  {"tiff", "image/tiff"},
+  {"wbmp", "image/vnd.wap.wbmp"},
+  {"ico", "image/x-icon"},
+  {"jng", "image/x-jng"},
+  {"bmp", "image/x-ms-bmp"},
+  {"svg", "image/svg+xml"},
+  {"svgz", "image/svg+xml"},
+  {"webp", "image/webp"},
+  {"woff", "application/font-woff"},
+  {"jar", "application/java-archive"},
+  {"war", "application/java-archive"},
+  {"ear", "application/java-archive"},
+  {"json", "application/json"},
+  {"hqx", "application/mac-binhex40"},
+  {"doc", "application/msword"},
+  {"pdf", "application/pdf"},
+  {"ps", "application/postscript"},
+  {"eps", "application/postscript"},
+  {"ai", "application/postscript"},
+  {"rtf", "application/rtf"},
+  {"m3u8", "application/vnd.apple.mpegurl"},
+  {"xls", "application/vnd.ms-excel"},
+  {"eot", "application/vnd.ms-fontobject"},
+  {"ppt", "application/vnd.ms-powerpoint"},
+  {"wmlc", "application/vnd.wap.wmlc"},
+  {"kml", "application/vnd.google-earth.kml+xml"},
+  {"kmz", "application/vnd.google-earth.kmz"},
+  {"7z", "application/x-7z-compressed"},
+  {"cco", "application/x-cocoa"},
+  {"jardiff", "application/x-java-archive-diff"},
+  {"jnlp", "application/x-java-jnlp-file"},
+  {"run", "application/x-makeself"},
+  {"pm", "application/x-perl"},
+  {"pl", "application/x-perl"},
+  {"pdb", "application/x-pilot"},
+  {"prc", "application/x-pilot"},
+  {"rar", "application/x-rar-compressed"},
+  {"rpm", "application/x-redhat-package-manager"},
+  {"sea", "application/x-sea"},
+  {"swf", "application/x-shockwave-flash"},
+  {"sit", "application/x-stuffit"},
+  {"tk", "application/x-tcl"},
+  {"tcl", "application/x-tcl"},
+  {"crt", "application/x-x509-ca-cert"},
+  {"pem", "application/x-x509-ca-cert"},
+  {"der", "application/x-x509-ca-cert"},
+  {"xpi", "application/x-xpinstall"},
+  {"xhtml", "application/xhtml+xml"},
+  {"xspf", "application/xspf+xml"},
+  {"zip", "application/zip"},
+  {"dll", "application/octet-stream"},
+  {"exe", "application/octet-stream"},
+  {"bin", "application/octet-stream"},
+  {"deb", "application/octet-stream"},
+  {"dmg", "application/octet-stream"},
+  {"img", "application/octet-stream"},
+  {"iso", "application/octet-stream"},
+  {"msm", "application/octet-stream"},
+  {"msp", "application/octet-stream"},
+  {"msi", "application/octet-stream"},
+  {"docx", "application/vnd.openxmlformats-officedocument.wordprocessingml.document"},
+  {"xlsx", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"},
+  {"pptx", "application/vnd.openxmlformats-officedocument.presentationml.presentation"},
+  {"kar", "audio/midi"},
+  {"midi", "audio/midi"},
+  {"mid", "audio/midi"},
+  {"mp3", "audio/mpeg"},
+  {"ogg", "audio/ogg"},
+  {"m4a", "audio/x-m4a"},
+  {"ra", "audio/x-realaudio"},
+  {"3gp", "video/3gpp"},
+  {"3gpp", "video/3gpp"},
+  {"ts", "video/mp2t"},
+  {"mp4", "video/mp4"},
+  {"mpg", "video/mpeg"},
+  {"mpeg", "video/mpeg"},
+  {"mov", "video/quicktime"},
+  {"webm", "video/webm"},
+  {"flv", "video/x-flv"},
+  {"m4v", "video/x-m4v"},
+  {"mng", "video/x-mng"},
+  {"asf", "video/x-ms-asf"},
+  {"asx", "video/x-ms-asf"},
+  {"wmv", "video/x-ms-wmv"},
+  {"avi", "video/x-msvideo"},
+}};
+
+// Mime_Table: perfect hash table of the mime types, built at compile time
+// each extension hashes to a bucket, and each bucket has a displacement
+// chosen so that every extension in the bucket lands in its own slot
+struct Mime_Table
+{
+  static constexpr std::size_t buckets {64};
+  static constexpr std::size_t slots {256};
+
+  // displacement of each bucket
+  std::array<std::uint64_t, buckets> disp {};
+
+  // index + 1 into the mime types of each slot, 0 if empty
+  std::array<std::uint8_t, slots> index {};
+}; // struct Mime_Table
+
+// case insensitive fnv-1a hash of a file extension
+constexpr std::uint64_t mime_hash(std::string_view str)
+{
+  std::uint64_t res {0xcbf29ce484222325};
+
+  for (std::size_t i = 0; i < str.size(); ++i)
+  {
+    auto c = static_cast<unsigned char>(str[i]);
+
+    if (c >= 'A' && c <= 'Z')
+    {
+      c += 'a' - 'A';
+    }
+
+    res ^= c;
+    res *= 0x100000001b3;
+  }
+
+  return res;
+}
+
+// slot of a hash with a bucket displacement, the top 8 bits of the mixed hash
+constexpr std::size_t mime_slot(std::uint64_t hash, std::uint64_t disp)
+{
+  return static_cast<std::size_t>(((hash ^ disp) * 0x9e3779b97f4a7c15) >> 56);
+}
+
+constexpr Mime_Table mime_table_init()
+{
+  static_assert(mime_builtin.size() < 256);
+
+  Mime_Table res {};
+
+  std::array<std::uint64_t, mime_builtin.size()> hashes {};
+  std::array<std::size_t, Mime_Table::buckets> sizes {};
+  std::array<bool, Mime_Table::buckets> done {};
+
+  for (std::size_t i = 0; i < mime_builtin.size(); ++i)
+  {
+    hashes[i] = mime_hash(mime_builtin[i].first);
+    ++sizes[hashes[i] % Mime_Table::buckets];
+  }
+
+  // place the largest remaining bucket first
+  for (std::size_t n = 0; n < Mime_Table::buckets; ++n)
+  {
+    std::size_t b {Mime_Table::buckets};
+
+    for (std::size_t i = 0; i < Mime_Table::buckets; ++i)
+    {
+      if (! done[i] && (b == Mime_Table::buckets || sizes[i] > sizes[b]))
+      {
+        b = i;
+      }
+    }
+
+    done[b] = true;
+
+    if (sizes[b] == 0)
+    {
+      break;
+    }
+
+    for (std::uint64_t disp = 0;; ++disp)
+    {
+      bool placed {true};
+
+      for (std::size_t i = 0; i < mime_builtin.size(); ++i)
+      {
+        if (hashes[i] % Mime_Table::buckets != b)
+        {
+          continue;
+        }
+
+        auto& slot = res.index[mime_slot(hashes[i], disp)];
+
+        if (slot != 0)
+        {
+          placed = false;
+          break;
+        }
+
+        slot = static_cast<std::uint8_t>(i + 1);
+      }
+
+      if (placed)
+      {
+        res.disp[b] = disp;
+        break;
+      }
+
+      // remove the extensions of the bucket placed with this displacement
+      for (std::size_t i = 0; i < mime_builtin.size(); ++i)
+      {
+        auto& slot = res.index[mime_slot(hashes[i], disp)];
+
+        if (hashes[i] % Mime_Table::buckets == b && slot == i + 1)
+        {
+          slot = 0;
+        }
+      }
+    }
+  }
+
+  return res;
+}
+
+inline constexpr Mime_Table mime_table {mime_table_init()};
+
+inline std::string_view mime_lookup(std::string_view path);
+
+// copy the built in mime types into a map
+inline std::unordered_map<std::string, std::string> mime_types_init()
+{
+  std::unordered_map<std::string, std::string> res;
+
+  for (auto const& [ext, type] : mime_builtin)
+  {
+    res.emplace(ext, type);
+  }
+
+  return res;
+}
+
+} // namespace Detail
+
+// mime types by lowercase file extension
+// lookups by path use the compile time table, this map is a read only copy
+inline std::unordered_map<std::string, std::string> const mime_types {Detail::mime_types_init()};
+
+// prototypes
+inline std::string mime_type(std::string_view path);
+
+// find the mime type of a string path
+inline std::string mime_type(std::string_view path)
+{
+  return std::string(Detail::mime_lookup(path));
+}
+
+namespace Detail
+{
+
+// find the mime type of a string path without copying it
+// the view refers to an entry of the built in types
+inline std::string_view mime_lookup(std::string_view path)
+{
+  auto const pos = path.rfind('.');
+
+  if (pos != std::string_view::npos && pos + 1 < path.size())
+  {
+    auto const ext = path.substr(pos + 1);
+    auto const hash = mime_hash(ext);
+    auto const index = mime_table.index[mime_slot(hash,
+      mime_table.disp[hash % Mime_Table::buckets])];
+
+    if (index != 0 && beast::iequals(
+      beast::string_view {ext.data(), ext.size()},
+      beast::string_view {mime_builtin[index - 1u].first.data(), mime_builtin[index - 1u].first.size()}))
+    {
+      return mime_builtin[index - 1u].second;
+    }
+  }
+
+  return "application/octet-stream";
+}
+
+} // namespace Detail
+
+class Request : public http::request<http::string_body>
+{
+  using Base = http::request<http::string_body>;
+
+public:
+
+  using Path = std::vector<std::string>;
+  using Params = Flat_Multimap<std::string, std::string>;
+  using Path_View = std::vector<std::string_view>;
+  using Params_View = std::vector<std::pair<std::string_view, std::string_view>>;
+
+  // inherit base constructors
+  using http::request<http::string_body>::message;
+
+  // default constructor
+  Request() = default;
+
+  // copy constructor
+  // views are rebased onto the copied target
+  Request(Request const& rhs) :
+    Base {rhs},
+    _path {rhs._path},
+    _params {rhs._params},
+    _params_view_parsed {rhs._params_view_parsed},
+    _params_deferred {rhs._params_deferred}
+  {
+    rebase_views(rhs);
+  }
+
+  // move constructor
+  Request(Request&&) = default;
+
+  // copy assignment
+  // views are rebased onto the copied target
+  Request& operator=(Request const& rhs)
+  {
+    if (this != &rhs)
+    {
+      Base::operator=(rhs);
+      _path = rhs._path;
+      _params = rhs._params;
+      _params_view_parsed = rhs._params_view_parsed;
+      _params_deferred = rhs._params_deferred;
+      rebase_views(rhs);
+    }
+
+    return *this;
+  }
+
+  // move assignment
+  Request& operator=(Request&& rhs) = default;
+
+  // default deconstructor
+  ~Request() = default;
+
+  Request&& move() noexcept
+  {
+    return std::move(*this);
+  }
+
+  // get the path
+  // created from the path views on first access
+  Path& path()
+  {
+    if (_path.empty() && ! _path_view.empty())
+    {
+      _path.reserve(_path_view.size());
+
+      for (auto const& e : _path_view)
+      {
+        _path.emplace_back(e);
+      }
+    }
+
+    return _path;
+  }
+
+  // get the path as views into the target
+  // index 0 contains the matched path, minus any query parameters
+  // index 1 to n contain the captures
+  // valid until the target is changed
+  // a copy of the request only rebases views that point into the target
+  Path_View& path_view()
+  {
+    return _path_view;
+  }
+
+  // get the raw query parameters as views into the target
+  // keys and values are not url decoded
+  // parsed on first access, valid until the target is changed
+  Params_View& params_view()
+  {
+    if (! _params_view_parsed)
+    {
+      _params_view_parsed = true;
+      params_parse_view();
+    }
+
+    return _params_view;
+  }
+
+  // get the query parameters
+  // parsed from the target on first access if deferred
+  Params& params()
+  {
+    if (_params_deferred)
+    {
+      params_parse();
+    }
+
+    return _params;
+  }
+
+  // find the first query parameter matching a key
+  // scans the target without parsing all of the query parameters
+  // the key and value are url decoded
+  std::optional<std::string> param(std::string_view key)
+  {
+    std::optional<std::string> res;
+
+    params_each(
+      [&](std::string_view k, std::string_view v)
+      {
+        if (Detail::url_find_escape(k, 0) == std::string_view::npos ? k != key : Detail::url_decode(k) != key)
+        {
+          return true;
+        }
+
+        res = Detail::url_decode(v);
+
+        return false;
+      }
+    );
+
+    return res;
+  }
+
+  // defer parsing the query parameters until the first access of params()
+  void params_defer()
+  {
+    _params_deferred = true;
+  }
+
+  // serialize path and query parameters to the target
+  void params_serialize()
+  {
+    std::string path {target().to_string()};
+
+    _path.clear();
+    _path.emplace_back(path);
+
+    if (! _params.empty())
+    {
+      path += "?";
+      auto it = _params.begin();
+      for (; it != _params.end(); ++it)
+      {
+        path += Detail::url_encode(it->first) + "=" + Detail::url_encode(it->second) + "&";
+      }
+      path.pop_back();
+    }
+
+    target(path);
+  }
+
+  // parse the query parameters from the target
+  // clears a deferred parse, so params() does not parse them again
+  void params_parse()
+  {
+    _params_deferred = false;
+
+    params_each(
+      [&](std::string_view k, std::string_view v)
+      {
+        _params.emplace(Detail::url_decode(k), Detail::url_decode(v));
+
+        return true;
+      }
+    );
+  }
+
+private:
+
+  // call a function with each raw key and value in the target query
+  // stops early if the function returns false
+  template<typename Fn>
+  void params_each(Fn const& fn)
+  {
+    std::string_view query {target().data(), target().size()};
+    auto const pos = query.find('?');
+
+    if (pos == std::string_view::npos)
+    {
+      return;
+    }
+
+    query.remove_prefix(pos + 1);
+
+    while (! query.empty())
+    {
+      auto const end = query.find('&');
+      auto const kv = query.substr(0, end);
+
+      if (! kv.empty())
+      {
+        auto const eq = kv.find('=');
+        bool next {true};
+
+        if (eq == std::string_view::npos)
+        {
+          next = fn(kv, kv.substr(kv.size()));
+        }
+        else
+        {
+          next = fn(kv.substr(0, eq), kv.substr(eq + 1));
+        }
+
+        if (! next)
+        {
+          return;
+        }
+      }
+
+      if (end == std::string_view::npos)
+      {
+        break;
+      }
+
+      query.remove_prefix(end + 1);
+    }
+  }
+
+  // parse the raw query parameters from the target into views
+  void params_parse_view()
+  {
+    _params_view.clear();
+
+    params_each(
+      [&](std::string_view k, std::string_view v)
+      {
+        _params_view.emplace_back(k, v);
+
+        return true;
+      }
+    );
+  }
+
+  // point the views of a copied request into this request's target
+  // views that are not inside the copied target are kept unchanged
+  void rebase_views(Request const& rhs)
+  {
+    auto const begin = reinterpret_cast<std::uintptr_t>(rhs.target().data());
+    auto const end = begin + rhs.target().size();
+
+    auto const rebase = [&](std::string_view str) -> std::string_view
+    {
+      if (str.empty())
+      {
+        return {};
+      }
+
+      auto const ptr = reinterpret_cast<std::uintptr_t>(str.data());
+
+      if (ptr < begin || ptr + str.size() > end)
+      {
+        return str;
+      }
+
+      return {target().data() + (ptr - begin), str.size()};
+    };
+
+    _path_view.clear();
+
+    for (auto const& e : rhs._path_view)
+    {
+      _path_view.emplace_back(rebase(e));
+    }
+
+    _params_view.clear();
+
+    for (auto const& [k, v] : rhs._params_view)
+    {
+      _params_view.emplace_back(rebase(k), rebase(v));
+    }
+  }
+
+  Path _path {};
+  Params _params {};
+  Path_View _path_view {};
+  Params_View _params_view {};
+  bool _params_view_parsed {false};
+  bool _params_deferred {false};
+}; // Request
+
+// store a type erased websocket
+struct Websocket_Session
+{
+  // default deconstructor
+  virtual ~Websocket_Session() = default;
+
+  // send a message
+  virtual void send(std::string const&&) = 0;
+
+  // send a shared message, the same buffer may be queued on many sessions
+  virtual void send(std::shared_ptr<std::string const>) = 0;
+
+  // get a weak reference to the session
+  virtual std::weak_ptr<Websocket_Session> weak() = 0;
+}; // struct Websocket_Session
+
+#ifdef OB_BELLE_CONFIG_SERVER_ON
+class Server
+{
+public:
+
+  // Channel: a group of websocket sessions to broadcast to
+  // safe to use from multiple threads, join and leave replace an immutable
+  // snapshot of the sessions, broadcast sends to the snapshot it takes
+  // sessions are held weakly, a closing session is skipped
+  class Channel
+  {
+  public:
+
+    using Sockets =
+      std::unordered_map<Websocket_Session const*, std::weak_ptr<Websocket_Session>>;
+
+    Channel()
+    {
+    }
+
+    Channel(Channel const& obj_) :
+      _sockets {obj_.sockets()}
+    {
+    }
+
+    Channel& operator=(Channel const& obj_)
+    {
+      auto sockets = obj_.sockets();
+
+      std::lock_guard<std::mutex> lock {_mtx};
+      _sockets = std::move(sockets);
+
+      return *this;
+    }
+
+    void join(Websocket_Session& socket_)
+    {
+      std::lock_guard<std::mutex> lock {_mtx};
+
+      auto sockets = std::make_shared<Sockets>(*_sockets);
+      sockets->insert_or_assign(&socket_, socket_.weak());
+      _sockets = std::move(sockets);
+    }
+
+    void leave(Websocket_Session& socket_)
+    {
+      std::lock_guard<std::mutex> lock {_mtx};
+
+      if (_sockets->find(&socket_) == _sockets->end())
+      {
+        return;
+      }
+
+      auto sockets = std::make_shared<Sockets>(*_sockets);
+      sockets->erase(&socket_);
+      _sockets = std::move(sockets);
+    }
+
+    void broadcast(std::string const&& str_) const
+    {
+      this->broadcast(std::make_shared<std::string const>(std::move(str_)));
+    }
+
+    // send the same message buffer to every session
+    void broadcast(std::shared_ptr<std::string const> const& str_) const
+    {
+      auto const sockets = this->sockets();
+
+      for (auto const& e : *sockets)
+      {
+        if (auto const socket = e.second.lock())
+        {
+          socket->send(str_);
+        }
+      }
+    }
+
+    std::size_t size() const
+    {
+      return this->sockets()->size();
+    }
+
+    // get a snapshot of the sessions
+    std::shared_ptr<Sockets const> sockets() const
+    {
+      std::lock_guard<std::mutex> lock {_mtx};
+
+      return _sockets;
+    }
+
+  private:
+
+    mutable std::mutex _mtx;
+    std::shared_ptr<Sockets const> _sockets {std::make_shared<Sockets const>()};
+  }; // class Channel
+
+  // Channels: websocket channels by name, safe to use from multiple threads
+  // channels are never removed, references to them stay valid
+  class Channels
+  {
+  public:
+
+    Channels()
+    {
+    }
+
+    // get a channel, creating it if missing
+    Channel& operator[](std::string const& name_)
+    {
+      std::lock_guard<std::mutex> lock {_mtx};
+
+      return _channels[name_];
+    }
+
+    // get a channel, throws std::out_of_range if missing
+    Channel& at(std::string const& name_)
+    {
+      std::lock_guard<std::mutex> lock {_mtx};
+
+      return _channels.at(name_);
+    }
+
+    // find a channel, nullptr if missing
+    Channel* find(std::string const& name_)
+    {
+      std::lock_guard<std::mutex> lock {_mtx};
+
+      auto const it = _channels.find(name_);
+
+      if (it == _channels.end())
+      {
+        return nullptr;
+      }
+
+      return &it->second;
+    }
+
+    std::size_t size() const
+    {
+      std::lock_guard<std::mutex> lock {_mtx};
+
+      return _channels.size();
+    }
+
+    // call fn_ with the name and channel of each channel
+    // fn_ is called without holding the lock
+    template<typename F>
+    void for_each(F&& fn_) const
+    {
+      std::vector<std::pair<std::string const*, Channel const*>> channels;
+
+      {
+        std::lock_guard<std::mutex> lock {_mtx};
+
+        channels.reserve(_channels.size());
+
+        for (auto const& e : _channels)
+        {
+          channels.emplace_back(&e.first, &e.second);
+        }
+      }
+
+      for (auto const& [name, channel] : channels)
+      {
+        fn_(*name, *channel);
+      }
+    }
+
+  private:
+
+    mutable std::mutex _mtx;
+    std::unordered_map<std::string, Channel> _channels;
+  }; // class Channels
+
+  template<typename Body>
+  struct Http_Ctx_Basic
+  {
+    Request req {};
+    http::response<Body> res {};
+    std::shared_ptr<void> data {nullptr};
+  }; // class Http_Ctx_Basic
+
+  using Http_Ctx = Http_Ctx_Basic<http::string_body>;
+
+  class Websocket_Ctx
+  {
+  public:
+
+    Websocket_Ctx(Websocket_Session& socket_, Request&& req_,
+      Channels& channels_) :
+      socket {&socket_},
+      req {std::move(req_)},
+      channels {channels_}
+    {
+    }
+
+    ~Websocket_Ctx()
+    {
+    }
+
+    void send(std::string const&& str_) const
+    {
+      socket->send(std::move(str_));
+    }
+
+    void send(std::shared_ptr<std::string const> str_) const
+    {
+      socket->send(std::move(str_));
+    }
+
+    void broadcast(std::string const&& str_) const
+    {
+      auto const pstr = std::make_shared<std::string const>(std::move(str_));
+
+      channels.for_each(
+        [&](std::string const&, Channel const& channel)
+        {
+          channel.broadcast(pstr);
+        }
+      );
+    }
+
+    Websocket_Session* socket;
+    Request req;
+    Channels& channels;
+    std::string msg {};
+    std::shared_ptr<void> data {nullptr};
+  }; // class Websocket_Ctx
+
+  // callbacks
+  using fn_on_signal = std::function<void(error_code, int)>;
+  using fn_on_http = Detail::Function<void(Http_Ctx&)>;
+  using fn_on_http_table = Detail::Function<bool(Http_Ctx&, std::string_view, Method)>;
+  using fn_on_websocket = Detail::Function<void(Websocket_Ctx&)>;
+
+  // http route with a literal path hashed at compile time
+  // and a concrete callback type
+  template<typename Fn>
+  struct Http_Fixed_Route
+  {
+    // run the callback if the path and method match
+    bool operator()(Http_Ctx& ctx_, std::string_view path_,
+      std::uint64_t hash_, Method method_) const
+    {
+      if (hash_ != hash || (method != Method::unknown && method != method_) ||
+        path_ != path)
+      {
+        return false;
+      }
+
+      // set the path
+      ctx_.req.path_view().emplace_back(path_);
+
+      // parse target params on first access
+      ctx_.req.params_defer();
+
+      // run user function
+      fn(ctx_);
+
+      return true;
+    }
+
+    std::string_view path;
+    std::uint64_t hash;
+    Method method;
+    Fn fn;
+  }; // struct Http_Fixed_Route
+
+  // compile time table of fixed http routes
+  // dispatch is a fold over the precomputed hashes,
+  // letting the compiler inline each callback
+  template<typename... Routes>
+  class Http_Route_Table
+  {
+  public:
+
+    constexpr Http_Route_Table(Routes... routes_) :
+      _routes {std::move(routes_)...}
+    {
+    }
+
+    // run the first route matching the path and method
+    bool operator()(Http_Ctx& ctx_, std::string_view path_, Method method_) const
+    {
+      auto const hash = Detail::hash(path_);
+
+      return std::apply(
+        [&](auto const&... e)
+        {
+          return (e(ctx_, path_, hash, method_) || ...);
+        },
+        _routes);
+    }
+
+  private:
+
+    std::tuple<Routes...> _routes;
+  }; // class Http_Route_Table
+
+  // create a fixed http route matching a single method
+  // the path must be a string literal, the route keeps a view of it
+  template<std::size_t N, typename Fn>
+  static constexpr Http_Fixed_Route<Fn> fixed_route(char const (&path_)[N],
+    Method method_, Fn fn_)
+  {
+    std::string_view const path {path_, N - 1};
+
+    return {path, Detail::hash(path), method_, std::move(fn_)};
+  }
+
+  // create a fixed http route matching all methods
+  // the path must be a string literal, the route keeps a view of it
+  template<std::size_t N, typename Fn>
+  static constexpr Http_Fixed_Route<Fn> fixed_route(char const (&path_)[N], Fn fn_)
+  {
+    std::string_view const path {path_, N - 1};
+
+    return {path, Detail::hash(path), Method::unknown, std::move(fn_)};
+  }
+
+  // create a compile time table of fixed http routes
+  template<typename... Routes>
+  static constexpr Http_Route_Table<Routes...> route_table(Routes... routes_)
+  {
+    return Http_Route_Table<Routes...>(std::move(routes_)...);
+  }
+
+  struct fns_on_websocket
+  {
+    fns_on_websocket(fn_on_websocket const& begin_,
+      fn_on_websocket const& data_, fn_on_websocket const& end_) :
+      begin {begin_},
+      data {data_},
+      end {end_}
+    {
+    }
+
+    fn_on_websocket begin {};
+    fn_on_websocket data {};
+    fn_on_websocket end {};
+  }; // struct fns_on_websocket
+
+  // http route callbacks with the route regex compiled once on registration
+  // callbacks are indexed by method, index 0 matches all methods
+  struct Http_Route
+  {
+    // the number of http methods
+    static constexpr std::size_t methods_size {static_cast<std::size_t>(Method::unlink) + 1};
+
+    static_assert(methods_size <= 64, "http method bitmask overflow");
+
+    Http_Route() = default;
+
+    Http_Route(std::string const& route_) :
+      rx {route_, std::regex::ECMAScript}
+    {
+    }
+
+    // set the callback for a method
+    void set(Method method_, fn_on_http const& fn_)
+    {
+      auto const index = static_cast<std::size_t>(method_);
+
+      fns[index] = fn_;
+      methods |= std::uint64_t {1} << index;
+    }
+
+    // get the callback for a method
+    // the all methods callback takes precedence
+    fn_on_http const* get(Method method_) const
+    {
+      if (methods & 1)
+      {
+        return &fns[0];
+      }
+
+      auto const index = static_cast<std::size_t>(method_);
+
+      if (methods & (std::uint64_t {1} << index))
+      {
+        return &fns[index];
+      }
+
+      return nullptr;
+    }
+
+    // check if a method has a callback
+    bool allowed(Method method_) const
+    {
+      return methods & (1 | (std::uint64_t {1} << static_cast<std::size_t>(method_)));
+    }
+
+    std::regex rx {};
+    std::array<fn_on_http, methods_size> fns {};
+
+    // bitmask of the methods with a callback
+    std::uint64_t methods {0};
+  }; // struct Http_Route
+
+  // websocket route callbacks with the route regex compiled once on registration
+  struct Websocket_Route
+  {
+    Websocket_Route(std::string const& route_, fns_on_websocket const& fns_) :
+      rx {route_, std::regex::ECMAScript},
+      fns {fns_}
+    {
+    }
+
+    std::regex rx {};
+    fns_on_websocket fns;
+  }; // struct Websocket_Route
+
+  // cached result of matching a method and path against the http routes
+  struct Http_Route_Cache_Entry
+  {
+    Method method {Method::unknown};
+    std::string path {};
+
+    // the matched route, nullptr if no route matched
+    Http_Route const* route {nullptr};
+
+    // offset and length of each capture in the path
+    std::vector<std::pair<std::size_t, std::size_t>> captures {};
+
+    // methods allowed on the path if no route matched
+    std::uint64_t allow {0};
+  }; // struct Http_Route_Cache_Entry
+
+  // cached resolution of a request target to a static file path
+  struct Http_Path_Cache_Entry
+  {
+    // the path of the request target, without the query
+    std::string target {};
+
+    // the file path in the public directory
+    std::string path {};
+  }; // struct Http_Path_Cache_Entry
+
+  // a file from the public directory held in memory
+  struct Http_File
+  {
+    // the file contents
+    std::shared_ptr<std::string const> body {};
+
+    // precomputed response headers
+    std::string content_type {};
+    std::string etag {};
+    std::string last_modified {};
+
+    // size and modification time, used to detect a changed file
+    std::uint64_t size {0};
+    std::time_t mtime {0};
+  }; // struct Http_File
+
+  // an open file from the public directory and when it expires
+  struct Http_Fd
+  {
+    std::shared_ptr<Detail::Open_File const> file {};
+    std::chrono::steady_clock::time_point expires {};
+  }; // struct Http_Fd
+
+  // aliases
+  using Http_Routes = Ordered_Map<std::string, Http_Route>;
+
+  using Http_Route_Cache =
+    Detail::Lru_Cache<std::uint64_t, std::shared_ptr<Http_Route_Cache_Entry const>>;
+
+  using Http_File_Cache =
+    Detail::Lru_Cache<std::string, std::shared_ptr<Http_File const>>;
+
+  using Http_Fd_Cache = Detail::Lru_Cache<std::string, Http_Fd>;
+
+  using Http_Path_Cache =
+    Detail::Lru_Cache<std::uint64_t, std::shared_ptr<Http_Path_Cache_Entry const>>;
+
+  using Cache_Stats = Detail::Cache_Stats;
+
+  using Websocket_Routes =
+    std::vector<std::pair<std::string, Websocket_Route>>;
+
+private:
+
+  struct Attr
+  {
+#ifdef OB_BELLE_CONFIG_SSL_ON
+    // use ssl
+    bool ssl {false};
+
+    // ssl context
+    ssl::context ssl_context {ssl::context::tlsv12_server};
+#endif // OB_BELLE_CONFIG_SSL_ON
+
+    // the public directory for serving static files
+    std::string public_dir {};
+
+    // default index filename for the public directory
+    std::string index_file {"index.html"};
+
+    // socket timeout
+    std::chrono::seconds timeout {10};
+
+    // serve static files from public directory
+    bool http_static {true};
+
+    // serve dynamic content
+    bool http_dynamic {true};
+
+    // upgrade http to websocket connection
+    bool websocket {true};
+
+    // default http headers
+    Headers http_headers {};
+
+    // http routes
+    Http_Routes http_routes {};
+
+    // http route lookup, built from the http routes on listen
+    Detail::Router<Http_Route const*> http_router {};
+
+    // compile time http route table, checked before the http routes
+    fn_on_http_table http_table {};
+
+    // cache of matched http routes by method and path
+    Http_Route_Cache http_route_cache {};
+
+    // cache of static file paths by request target
+    Http_Path_Cache http_path_cache {};
+
+    // cache of static files by path, the cost of each entry is its size
+    Http_File_Cache http_static_cache {};
+
+    // cache of open static files by path, including missing files
+    Http_Fd_Cache http_fd_cache {};
+
+    // invalidate the static file caches when the public directory changes
+    bool http_static_watch {false};
+
+    // time an open file cache entry is used before the file is reopened
+    std::chrono::seconds http_fd_cache_ttl {10};
+
+    // number of threads reading static files, reads are inline if 0
+    std::size_t http_file_threads {0};
+
+    // thread pool reading static files, created on listen
+    std::unique_ptr<net::thread_pool> file_pool {};
+
+    // send static files from a shared read only memory mapping
+    bool http_mmap {false};
+
+    // largest file size sent from a memory mapping
+    std::uint64_t http_mmap_max {std::uint64_t {1} << 30};
+
+    // cache control header value for static files, unset if empty
+    std::string http_static_cache_control {};
+
+    // serve precompressed siblings of static files
+    bool http_precompressed {false};
+
+    // send static files with sendfile on plain http connections
+    bool http_sendfile {true};
+
+    // largest file size stored in the static file cache
+    std::size_t http_static_cache_max {1024 * 1024};
+
+    // websocket routes
+    Websocket_Routes websocket_routes {};
+
+    // callbacks for http
+    fn_on_http on_http_error {};
+    fn_on_http on_http_connect {};
+    fn_on_http on_http_disconnect {};
+
+    // callbacks for websocket
+    fn_on_websocket on_websocket_error {};
+    fn_on_websocket on_websocket_connect {};
+    fn_on_websocket on_websocket_disconnect {};
+
+    // websocket channels
+    Channels channels {};
+  }; // struct Attr
+
+  template<typename Derived>
+  class Websocket_Base : public Websocket_Session
+  {
+    Derived& derived()
+    {
+      return static_cast<Derived&>(*this);
+    }
+
+  public:
+
+    Websocket_Base(net::io_context& io_, std::shared_ptr<Attr> const attr_,
+      Request&& req_, fns_on_websocket const& on_websocket_) :
+      _attr {attr_},
+      _ctx {static_cast<Derived&>(*this), std::move(req_), _attr->channels},
+      _on_websocket {on_websocket_},
+      _strand {io_.get_executor()}
+    {
+    }
+
+    ~Websocket_Base()
+    {
+      // leave channel
+      _attr->channels.at(_ctx.req.path().at(0)).leave(derived());
+
+      if (_on_websocket.end)
+      {
+        try
+        {
+          // run user function
+          _on_websocket.end(_ctx);
+        }
+        catch (...)
+        {
+          this->handle_error();
+        }
+      }
+
+      if (_attr->on_websocket_disconnect)
+      {
+        try
+        {
+          // run user function
+          _attr->on_websocket_disconnect(_ctx);
+        }
+        catch (...)
+        {
+          this->handle_error();
+        }
+      }
+    }
+
+    // send a message, safe to call from any thread
+    // the message is queued on the session strand
+    void send(std::string const&& str_)
+    {
+      this->send(std::make_shared<std::string const>(std::move(str_)));
+    }
+
+    // send a shared message without copying it
+    void send(std::shared_ptr<std::string const> pstr_)
+    {
+      net::dispatch(_strand,
+        [self = derived().shared_from_this(), pstr = std::move(pstr_)]() mutable
+        {
+          self->do_write(std::move(pstr));
+        }
+      );
+    }
+
+    std::weak_ptr<Websocket_Session> weak()
+    {
+      return derived().weak_from_this();
+    }
+
+    void do_write(std::shared_ptr<std::string const> pstr_)
+    {
+      _que.emplace_back(std::move(pstr_));
+
+      if (_que.size() > 1)
+      {
+        return;
+      }
+
+      derived().socket().async_write(net::buffer(*_que.front()),
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this()](error_code ec, std::size_t bytes)
+          {
+            self->on_write(ec, bytes);
+          }
+        )
+      );
+    }
+
+    void handle_error()
+    {
+      if (_attr->on_websocket_error)
+      {
+        try
+        {
+          // run user function
+          _attr->on_websocket_error(_ctx);
+        }
+        catch (...)
+        {
+        }
+      }
+    }
+
+    void do_accept()
+    {
+      derived().socket().control_callback(
+        [this](websocket::frame_type type, boost::beast::string_view data)
+        {
+          this->on_control_callback(type, data);
+        }
+      );
+
+      derived().socket().async_accept_ex(_ctx.req,
+        [&](auto& res)
+        {
+          for (auto const& e : _attr->http_headers)
+          {
+            res.insert(e.name_string(), e.value());
+          }
+        },
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this()](error_code ec)
+          {
+            self->on_accept(ec);
+          }
+        )
+      );
+    }
+
+    void on_accept(error_code ec_)
+    {
+      if (ec_ == net::error::operation_aborted)
+      {
+        return;
+      }
+
+      if (ec_)
+      {
+        // TODO log here
+        return;
+      }
+
+      // join channel
+      _attr->channels[_ctx.req.path().at(0)].join(derived());
+
+      if (_attr->on_websocket_connect)
+      {
+        try
+        {
+          // run user function
+          _attr->on_websocket_connect(_ctx);
+        }
+        catch (...)
+        {
+          this->handle_error();
+        }
+      }
+
+      if (_on_websocket.begin)
+      {
+        try
+        {
+          // run user function
+          _on_websocket.begin(_ctx);
+        }
+        catch (...)
+        {
+          this->handle_error();
+        }
+      }
+
+      this->do_read();
+    }
+
+    void on_control_callback(websocket::frame_type type_, boost::beast::string_view data_)
+    {
+      boost::ignore_unused(type_, data_);
+    }
+
+    void do_read()
+    {
+      derived().socket().async_read(_buf,
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this()](error_code ec, std::size_t bytes)
+          {
+            self->on_read(ec, bytes);
+          }
+        )
+      );
+    }
+
+    void on_read(error_code ec_, std::size_t bytes_)
+    {
+      boost::ignore_unused(bytes_);
+
+      // socket closed by the timer
+      if (ec_ == net::error::operation_aborted)
+      {
+        return;
+      }
+
+      // socket closed
+      if (ec_ == websocket::error::closed)
+      {
+        return;
+      }
+
+      if (ec_)
+      {
+        // TODO log here
+        return;
+      }
+
+      if (_on_websocket.data)
+      {
+        try
+        {
+          _ctx.msg = boost::beast::buffers_to_string(_buf.data());
+
+          // run user function
+          _on_websocket.data(_ctx);
+        }
+        catch (...)
+        {
+          handle_error();
+        }
+      }
+
+      // clear the request object
+      _ctx.req.clear();
+
+      // clear the buffers
+      _buf.consume(_buf.size());
+
+      this->do_read();
+    }
+
+    void on_write(error_code ec_, std::size_t bytes_)
+    {
+      boost::ignore_unused(bytes_);
+
+      // happens when the timer closes the socket
+      if (ec_ == net::error::operation_aborted)
+      {
+        return;
+      }
+
+      if (ec_)
+      {
+        // TODO log here
+        return;
+      }
+
+      // remove sent message from the queue
+      _que.pop_front();
+
+      if (_que.empty())
+      {
+        return;
+      }
+
+      derived().socket().async_write(net::buffer(*_que.front()),
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this()](error_code ec, std::size_t bytes)
+          {
+            self->on_write(ec, bytes);
+          }
+        )
+      );
+    }
+
+    std::shared_ptr<Attr> const _attr;
+    Websocket_Ctx _ctx;
+    fns_on_websocket const& _on_websocket;
+    net::strand<net::io_context::executor_type> _strand;
+    boost::beast::multi_buffer _buf;
+    std::deque<std::shared_ptr<std::string const>> _que {};
+  }; // class Websocket_Base
+
+  class Websocket :
+    public Websocket_Base<Websocket>,
+    public std::enable_shared_from_this<Websocket>
+  {
+  public:
+
+    Websocket(tcp::socket&& socket_, std::shared_ptr<Attr> const attr_,
+      Request&& req_, fns_on_websocket const& on_websocket_) :
+      Websocket_Base<Websocket> {socket_.get_executor().context(), attr_,
+        std::move(req_), on_websocket_},
+      _socket {std::move(socket_)}
+    {
+    }
+
+    ~Websocket()
+    {
+    }
+
+    websocket::stream<tcp::socket>& socket()
+    {
+      return _socket;
+    }
+
+    void run()
+    {
+      this->do_accept();
+    }
+
+    void do_timeout()
+    {
+      this->do_shutdown();
+    }
+
+    void do_shutdown()
+    {
+      _socket.async_close(websocket::close_code::normal,
+        net::bind_executor(this->_strand,
+          [self = this->shared_from_this()](error_code ec)
+          {
+            self->on_shutdown(ec);
+          }
+        )
+      );
+    }
+
+    void on_shutdown(error_code ec_)
+    {
+      if (ec_)
+      {
+        // TODO log here
+        return;
+      }
+    }
+
+  private:
+
+    websocket::stream<tcp::socket> _socket;
+  }; // class Websocket
+
+#ifdef OB_BELLE_CONFIG_SSL_ON
+  class Websockets :
+    public Websocket_Base<Websockets>,
+    public std::enable_shared_from_this<Websockets>
+  {
+  public:
+
+    Websockets(Detail::ssl_stream<tcp::socket>&& socket_, std::shared_ptr<Attr> const attr_,
+      Request&& req_, fns_on_websocket const& on_websocket_) :
+      Websocket_Base<Websockets> {socket_.get_executor().context(), attr_,
+        std::move(req_), on_websocket_},
+      _socket {std::move(socket_)}
+    {
+    }
+
+    ~Websockets()
+    {
+    }
+
+    websocket::stream<Detail::ssl_stream<tcp::socket>>& socket()
+    {
+      return _socket;
+    }
+
+    void run()
+    {
+      this->do_accept();
+    }
+
+    void do_timeout()
+    {
+      this->do_shutdown();
+    }
+
+    void do_shutdown()
+    {
+      _socket.async_close(websocket::close_code::normal,
+        net::bind_executor(this->_strand,
+          [self = this->shared_from_this()](error_code ec)
+          {
+            self->on_shutdown(ec);
+          }
+        )
+      );
+    }
+
+    void on_shutdown(error_code ec_)
+    {
+      if (ec_)
+      {
+        // TODO log here
+        return;
+      }
+    }
+
+  private:
+
+    websocket::stream<Detail::ssl_stream<tcp::socket>> _socket;
+  }; // class Websockets
+#endif // OB_BELLE_CONFIG_SSL_ON
+
+  template<typename Derived, typename Websocket_Type>
+  class Http_Base
+  {
+    Derived& derived()
+    {
+      return static_cast<Derived&>(*this);
+    }
+
+  public:
+
+    Http_Base(net::io_context& io_, std::shared_ptr<Attr> const attr_) :
+      _strand {io_.get_executor()},
+      _timer {io_, (std::chrono::steady_clock::time_point::max)()},
+      _attr {attr_}
+    {
+    }
+
+    ~Http_Base()
+    {
+    }
+
+// TODO remove shim once visual studio supports generic lambdas
+#ifdef _MSC_VER
+    template<typename Self, typename Res>
+    static void constexpr send(Self self, Res&& res)
+#else
+    // generic lambda for sending different types of responses
+    static auto constexpr send = [](auto self, auto&& res) -> void
+#endif // _MSC_VER
+    {
+      using item_type = std::remove_reference_t<decltype(res)>;
+
+      auto ptr = std::make_shared<item_type>(std::move(res));
+      self->_res = ptr;
+
+      http::async_write(self->derived().socket(), *ptr,
+        net::bind_executor(self->_strand,
+          [self, close = ptr->need_eof()]
+          (error_code ec, std::size_t bytes)
+          {
+            self->on_write(ec, bytes, close);
+          }
+        )
+      );
+    };
+
+    int serve_static()
+    {
+      if (! _attr->http_static || _attr->public_dir.empty())
+      {
+        return 404;
+      }
+
+      if ((_ctx.req.method() != http::verb::get) && (_ctx.req.method() != http::verb::head))
+      {
+        return 404;
+      }
+
+      auto const resolved = this->static_path();
+
+      if (! resolved)
+      {
+        return 404;
+      }
+
+      auto const& path = *resolved;
+
+      // the file to send, a precompressed sibling if the client accepts one
+      std::string file {path};
+      std::string_view encoding {};
+      std::shared_ptr<Detail::Open_File const> fd;
+
+      if (_attr->http_precompressed)
+      {
+        auto const accept = _ctx.req[Header::accept_encoding];
+
+        for (auto const& [name, ext] : Detail::precompressed)
+        {
+          if (Detail::http_accepts({accept.data(), accept.size()}, name))
+          {
+            if (auto sibling = this->static_open(path + ext.data()); sibling->is_open())
+            {
+              fd = std::move(sibling);
+              file = path + ext.data();
+              encoding = name;
+              break;
+            }
+          }
+        }
+      }
+
+      if (! fd)
+      {
+        fd = this->static_open(path);
+
+        if (! fd->is_open())
+        {
+          if (_attr->http_static_cache.capacity())
+          {
+            _attr->http_static_cache.erase(path);
+          }
+
+          return 404;
+        }
+      }
+
+      auto const& st = fd->status();
+
+      // conditional request
+      auto const etag = Detail::http_etag(st.st_mtime, static_cast<std::uint64_t>(st.st_size));
+
+      if (this->not_modified(etag, st.st_mtime))
+      {
+        http::response<http::empty_body> res {};
+        res.base() = http::response_header<>(_attr->http_headers);
+        res.result(Status::not_modified);
+        res.version(_ctx.req.version());
+        res.keep_alive(_ctx.req.keep_alive());
+        res.set(Header::etag, etag);
+        res.set(Header::last_modified, Detail::http_date(st.st_mtime));
+        this->cache_control_headers(res);
+        this->encoding_headers(res, encoding);
+        send(derived().shared_from_this(), std::move(res));
+        return 0;
+      }
+
+      // range request
+      auto const ranges = this->static_ranges(etag, st.st_mtime,
+        static_cast<std::uint64_t>(st.st_size));
+
+      if (ranges && ranges->empty())
+      {
+        _ctx.res.set(Header::content_range, "bytes */" + std::to_string(st.st_size));
+        return 416;
+      }
+
+      // serve from the static file cache
+      if (_attr->http_static_cache.capacity())
+      {
+        if (auto const entry = this->static_file(file, path, *fd))
+        {
+          if (_ctx.req.method() == http::verb::head)
+          {
+            http::response<http::empty_body> res {};
+            res.base() = http::response_header<>(_attr->http_headers);
+            this->static_headers(res, *entry, encoding);
+            send(derived().shared_from_this(), std::move(res));
+            return 0;
+          }
+
+          if (ranges)
+          {
+            Detail::Range_Body::value_type body;
+            body.contents = {entry->body, *entry->body};
+            this->send_ranges(std::move(body), *ranges, *entry, encoding);
+            return 0;
+          }
+
+          http::response<Detail::Shared_Body> res {
+            std::piecewise_construct,
+            std::make_tuple(Detail::Shared_Body::value_type {entry->body, *entry->body}),
+            std::make_tuple(_attr->http_headers)
+          };
+          this->static_headers(res, *entry, encoding);
+          send(derived().shared_from_this(), std::move(res));
+          return 0;
         }
       }
-    }
 
-    void send(std::string const&& str_)
-    {
-      auto const pstr = std::make_shared<std::string const>(std::move(str_));
-      _que.emplace_back(pstr);
+      auto const info = this->static_info(path, st);
 
-      if (_que.size() > 1)
+      // head request
+      if (_ctx.req.method() == http::verb::head)
       {
-        return;
+        http::response<http::empty_body> res {};
+        res.base() = http::response_header<>(_attr->http_headers);
+        this->static_headers(res, info, encoding);
+        send(derived().shared_from_this(), std::move(res));
+        return 0;
       }
 
-      derived().socket().async_write(net::buffer(*_que.front()),
-        [self = derived().shared_from_this()](error_code ec, std::size_t bytes)
-        {
-          self->on_write(ec, bytes);
-        }
-      );
+      // get request with ranges
+      if (ranges)
+      {
+        Detail::Range_Body::value_type body;
+        body.contents = this->static_map(fd);
+        body.file = std::move(fd);
+        this->send_ranges(std::move(body), *ranges, info, encoding);
+        return 0;
+      }
+
+      // get request
+      http::response<Detail::File_Body<>> res {
+        std::piecewise_construct,
+        std::make_tuple(std::move(fd)),
+        std::make_tuple(_attr->http_headers)
+      };
+      this->static_headers(res, info, encoding);
+      derived().send_file(std::move(res));
+      return 0;
     }
 
-    void handle_error()
+    // parse the range header of a get request for a static file
+    // returns nullopt to send the whole file, or an empty list if no range is satisfiable
+    std::optional<Detail::Ranges> static_ranges(std::string_view etag_,
+      std::time_t mtime_, std::uint64_t size_)
     {
-      if (_attr->on_websocket_error)
+      auto const range = _ctx.req[Header::range];
+
+      if (range.empty() || _ctx.req.method() != http::verb::get)
       {
-        try
-        {
-          // run user function
-          _attr->on_websocket_error(_ctx);
-        }
-        catch (...)
-        {
-        }
+        return {};
       }
-    }
 
-    void do_accept()
-    {
-      derived().socket().control_callback(
-        [this](websocket::frame_type type, boost::beast::string_view data)
-        {
-          this->on_control_callback(type, data);
-        }
-      );
+      // the ranges are only sent if the file is unchanged,
+      // an entity tag must match exactly and a date must equal the modification time
+      auto const if_range = _ctx.req[Header::if_range];
 
-      derived().socket().async_accept_ex(_ctx.req,
-        [&](auto& res)
+      if (! if_range.empty())
+      {
+        std::string_view const val {if_range.data(), if_range.size()};
+
+        if (val.front() == '"' || val.substr(0, 2) == "W/")
         {
-          for (auto const& e : _attr->http_headers)
+          if (val != etag_)
           {
-            res.insert(e.name_string(), e.value());
+            return {};
           }
-        },
-        net::bind_executor(_strand,
-          [self = derived().shared_from_this()](error_code ec)
+        }
+        else
+        {
+          auto const time = Detail::http_date_parse(val);
+
+          if (! time || time.value() != mtime_)
           {
-            self->on_accept(ec);
+            return {};
           }
-        )
-      );
+        }
+      }
+
+      return Detail::http_ranges({range.data(), range.size()}, size_, ranges_max);
     }
 
-    void on_accept(error_code ec_)
+    // send a 206 partial content response for the ranges of a static file
+    // multiple ranges are sent as multipart/byteranges
+    void send_ranges(Detail::Range_Body::value_type&& body_, Detail::Ranges const& ranges_,
+      Http_File const& file_, std::string_view encoding_)
     {
-      if (ec_ == net::error::operation_aborted)
+      auto const content_range = [&](auto const& range)
       {
-        return;
-      }
+        return "bytes " + std::to_string(range.first) + "-" + std::to_string(range.second) +
+          "/" + std::to_string(file_.size);
+      };
 
-      if (ec_)
-      {
-        // TODO log here
-        return;
-      }
+      http::response<Detail::Range_Body> res {
+        std::piecewise_construct,
+        std::make_tuple(std::move(body_)),
+        std::make_tuple(_attr->http_headers)
+      };
+      this->static_headers(res, file_, encoding_);
+      res.result(Status::partial_content);
 
-      // join channel
-      if (_attr->channels.find(_ctx.req.path().at(0)) == _attr->channels.end())
-      {
-        _attr->channels[_ctx.req.path().at(0)] = Channel();
-      }
-      _attr->channels.at(_ctx.req.path().at(0)).join(derived());
+      auto& body = res.body();
 
-      if (_attr->on_websocket_connect)
+      if (ranges_.size() == 1)
       {
-        try
-        {
-          // run user function
-          _attr->on_websocket_connect(_ctx);
-        }
-        catch (...)
-        {
-          this->handle_error();
-        }
+        auto const& range = ranges_.front();
+        body.parts.push_back({{}, range.first, range.second - range.first + 1});
+        res.set(Header::content_range, content_range(range));
       }
-
-      if (_on_websocket.begin)
+      else
       {
-        try
-        {
-          // run user function
-          _on_websocket.begin(_ctx);
-        }
-        catch (...)
+        auto const boundary = Detail::http_boundary();
+
+        for (auto const& range : ranges_)
         {
-          this->handle_error();
+          body.parts.push_back({
+            (body.parts.empty() ? "--" : "\r\n--") + boundary +
+            "\r\nContent-Type: " + file_.content_type +
+            "\r\nContent-Range: " + content_range(range) + "\r\n\r\n",
+            range.first, range.second - range.first + 1});
         }
+
+        body.tail = "\r\n--" + boundary + "--\r\n";
+        res.set(Header::content_type, "multipart/byteranges; boundary=" + boundary);
       }
 
-      this->do_read();
+      res.content_length(body.size());
+      this->send_range_body(std::move(res));
     }
 
-    void on_control_callback(websocket::frame_type type_, boost::beast::string_view data_)
+    // send a range body, reading the file on the file thread pool if enabled
+    // the header is written by a serializer, then each part is read and written in turn
+    void send_range_body(http::response<Detail::Range_Body>&& res_)
     {
-      boost::ignore_unused(type_, data_);
-    }
+      if (! _attr->file_pool || res_.body().contents.data.data())
+      {
+        send(derived().shared_from_this(), std::move(res_));
+        return;
+      }
 
-    void do_read()
-    {
-      derived().socket().async_read(_buf,
+      auto op = std::make_shared<File_Op>(std::move(res_));
+      op->close = op->res.need_eof();
+      _res = op;
+
+      http::async_write_header(derived().socket(), op->sr,
         net::bind_executor(_strand,
-          [self = derived().shared_from_this()](error_code ec, std::size_t bytes)
+          [self = derived().shared_from_this(), op](error_code ec, std::size_t bytes)
           {
-            self->on_read(ec, bytes);
+            boost::ignore_unused(bytes);
+
+            if (ec)
+            {
+              self->on_write(ec, 0, op->close);
+              return;
+            }
+
+            self->do_file_write(op);
           }
         )
       );
     }
 
-    void on_read(error_code ec_, std::size_t bytes_)
+    struct File_Op
     {
-      boost::ignore_unused(bytes_);
-
-      // socket closed by the timer
-      if (ec_ == net::error::operation_aborted)
+      File_Op(http::response<Detail::Range_Body>&& res_) :
+        res {std::move(res_)}
       {
-        return;
       }
 
-      // socket closed
-      if (ec_ == websocket::error::closed)
-      {
-        return;
-      }
+      http::response<Detail::Range_Body> res;
+      http::response_serializer<Detail::Range_Body> sr {res};
+      std::size_t part {0};
+      std::uint64_t pos {0};
+      bool head {false};
+      bool tail {false};
+      bool close {false};
+      std::array<char, 65536> buf;
+    }; // struct File_Op
 
-      if (ec_)
-      {
-        // TODO log here
-        return;
-      }
+    // write the next part head, file block, or tail of a file op
+    // file blocks are read on the file thread pool, then written on the strand
+    void do_file_write(std::shared_ptr<File_Op> op_)
+    {
+      auto const& body = op_->res.body();
 
-      if (_on_websocket.data)
+      while (op_->part < body.parts.size())
       {
-        try
+        auto const& part = body.parts[op_->part];
+
+        if (! op_->head)
         {
-          _ctx.msg = boost::beast::buffers_to_string(_buf.data());
+          op_->head = true;
+          op_->pos = 0;
 
-          // run user function
-          _on_websocket.data(_ctx);
+          if (! part.head.empty())
+          {
+            this->do_file_write_buffer(op_, net::buffer(part.head));
+            return;
+          }
         }
-        catch (...)
+
+        if (op_->pos == part.size)
         {
-          handle_error();
+          ++op_->part;
+          op_->head = false;
+          continue;
         }
-      }
-
-      // clear the request object
-      _ctx.req.clear();
 
-      // clear the buffers
-      _buf.consume(_buf.size());
+        auto const offset = part.offset + op_->pos;
+        auto const amount = static_cast<std::size_t>(
+          std::min<std::uint64_t>(part.size - op_->pos, op_->buf.size()));
 
-      this->do_read();
-    }
+        net::post(*_attr->file_pool,
+          [self = derived().shared_from_this(), op_, offset, amount]()
+          {
+            error_code ec;
+            auto const bytes = op_->res.body().file->read(offset, op_->buf.data(), amount, ec);
 
-    void on_write(error_code ec_, std::size_t bytes_)
-    {
-      boost::ignore_unused(bytes_);
+            if (! ec && bytes == 0)
+            {
+              // the file was truncated
+              ec = net::error::eof;
+            }
 
-      // happens when the timer closes the socket
-      if (ec_ == net::error::operation_aborted)
-      {
-        return;
-      }
+            net::post(self->_strand,
+              [self, op_, ec, bytes]()
+              {
+                if (ec)
+                {
+                  self->on_write(ec, 0, op_->close);
+                  return;
+                }
+
+                op_->pos += bytes;
+                self->do_file_write_buffer(op_, net::buffer(op_->buf.data(), bytes));
+              }
+            );
+          }
+        );
 
-      if (ec_)
-      {
-        // TODO log here
         return;
       }
 
-      // remove sent message from the queue
-      _que.pop_front();
-
-      if (_que.empty())
+      if (! op_->tail)
       {
-        return;
-      }
+        op_->tail = true;
 
-      derived().socket().async_write(net::buffer(*_que.front()),
-        [self = derived().shared_from_this()](error_code ec, std::size_t bytes)
+        if (! body.tail.empty())
         {
-          self->on_write(ec, bytes);
+          this->do_file_write_buffer(op_, net::buffer(body.tail));
+          return;
         }
-      );
-    }
-
-    std::shared_ptr<Attr> const _attr;
-    Websocket_Ctx _ctx;
-    fns_on_websocket const& _on_websocket;
-    net::strand<net::io_context::executor_type> _strand;
-    boost::beast::multi_buffer _buf;
-    std::deque<std::shared_ptr<std::string const>> _que {};
-  }; // class Websocket_Base
-
-  class Websocket :
-    public Websocket_Base<Websocket>,
-    public std::enable_shared_from_this<Websocket>
-  {
-  public:
-
-    Websocket(tcp::socket&& socket_, std::shared_ptr<Attr> const attr_,
-      Request&& req_, fns_on_websocket const& on_websocket_) :
-      Websocket_Base<Websocket> {socket_.get_executor().context(), attr_,
-        std::move(req_), on_websocket_},
-      _socket {std::move(socket_)}
-    {
-    }
-
-    ~Websocket()
-    {
-    }
+      }
 
-    websocket::stream<tcp::socket>& socket()
-    {
-      return _socket;
+      this->on_write({}, 0, op_->close);
     }
 
-    void run()
+    void do_file_write_buffer(std::shared_ptr<File_Op> op_, net::const_buffer buf_)
     {
-      this->do_accept();
-    }
+      net::async_write(derived().socket(), buf_,
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this(), op_](error_code ec, std::size_t bytes)
+          {
+            boost::ignore_unused(bytes);
 
-    void do_timeout()
-    {
-      this->do_shutdown();
-    }
+            if (ec)
+            {
+              self->on_write(ec, 0, op_->close);
+              return;
+            }
 
-    void do_shutdown()
-    {
-      _socket.async_close(websocket::close_code::normal,
-        net::bind_executor(this->_strand,
-          [self = this->shared_from_this()](error_code ec)
-          {
-            self->on_shutdown(ec);
+            self->do_file_write(op_);
           }
         )
       );
     }
 
-    void on_shutdown(error_code ec_)
+    // check the conditional request headers against a static file
+    // if-none-match takes precedence over if-modified-since
+    bool not_modified(std::string_view etag_, std::time_t mtime_)
     {
-      if (ec_)
+      auto const none_match = _ctx.req[Header::if_none_match];
+
+      if (! none_match.empty())
       {
-        // TODO log here
-        return;
+        return Detail::http_etag_match({none_match.data(), none_match.size()}, etag_);
       }
-    }
-
-  private:
-
-    websocket::stream<tcp::socket> _socket;
-  }; // class Websocket
 
-#ifdef OB_BELLE_CONFIG_SSL_ON
-  class Websockets :
-    public Websocket_Base<Websockets>,
-    public std::enable_shared_from_this<Websockets>
-  {
-  public:
+      auto const modified_since = _ctx.req[Header::if_modified_since];
 
-    Websockets(Detail::ssl_stream<tcp::socket>&& socket_, std::shared_ptr<Attr> const attr_,
-      Request&& req_, fns_on_websocket const& on_websocket_) :
-      Websocket_Base<Websockets> {socket_.get_executor().context(), attr_,
-        std::move(req_), on_websocket_},
-      _socket {std::move(socket_)}
-    {
+      if (! modified_since.empty())
+      {
+        if (auto const time = Detail::http_date_parse({modified_since.data(), modified_since.size()}))
+        {
+          return mtime_ <= time.value();
+        }
+      }
+
+      return false;
     }
 
-    ~Websockets()
+    // send a file response, overridden by sessions that can send without copying
+    // the file is sent from a memory mapping, or read on the file thread pool, if enabled
+    void send_file(http::response<Detail::File_Body<>>&& res_)
     {
+      if (auto contents = this->static_map(res_.body()); contents.data.data())
+      {
+        send(derived().shared_from_this(), http::response<Detail::Shared_Body> {
+          std::move(res_.base()), std::move(contents)});
+        return;
+      }
+
+      if (_attr->file_pool)
+      {
+        Detail::Range_Body::value_type body;
+        body.parts.push_back({{}, 0, res_.body()->size()});
+        body.file = std::move(res_.body());
+        this->send_range_body(http::response<Detail::Range_Body> {
+          std::move(res_.base()), std::move(body)});
+        return;
+      }
+
+      send(derived().shared_from_this(), std::move(res_));
     }
 
-    websocket::stream<Detail::ssl_stream<tcp::socket>>& socket()
+    // map a static file if memory mapping is enabled and the file is small enough
+    // the view is null if the file is not mapped
+    Detail::Shared_Body::value_type static_map(
+      std::shared_ptr<Detail::Open_File const> const& fd_)
     {
-      return _socket;
+      if (! _attr->http_mmap || fd_->size() > _attr->http_mmap_max)
+      {
+        return {};
+      }
+
+      return {fd_, fd_->map()};
     }
 
-    void run()
+    // set the headers of a response for a static file
+    template<typename Res>
+    void static_headers(Res& res_, Http_File const& file_, std::string_view encoding_)
     {
-      this->do_accept();
+      res_.version(_ctx.req.version());
+      res_.keep_alive(_ctx.req.keep_alive());
+      res_.content_length(file_.size);
+      res_.set(Header::content_type, file_.content_type);
+      res_.set(Header::accept_ranges, "bytes");
+      res_.set(Header::etag, file_.etag);
+      res_.set(Header::last_modified, file_.last_modified);
+      this->cache_control_headers(res_);
+      this->encoding_headers(res_, encoding_);
     }
 
-    void do_timeout()
+    // set the cache control header of a static file response
+    template<typename Res>
+    void cache_control_headers(Res& res_)
     {
-      this->do_shutdown();
+      if (! _attr->http_static_cache_control.empty())
+      {
+        res_.set(Header::cache_control, _attr->http_static_cache_control);
+      }
     }
 
-    void do_shutdown()
+    // get the headers of a static file without its contents
+    // the content type is taken from type_path_
+    static Http_File static_info(std::string const& type_path_, struct stat const& st_)
     {
-      _socket.async_close(websocket::close_code::normal,
-        net::bind_executor(this->_strand,
-          [self = this->shared_from_this()](error_code ec)
-          {
-            self->on_shutdown(ec);
-          }
-        )
-      );
+      Http_File res;
+      res.content_type = Detail::mime_lookup(type_path_);
+      res.size = static_cast<std::uint64_t>(st_.st_size);
+      res.mtime = st_.st_mtime;
+      res.etag = Detail::http_etag(res.mtime, res.size);
+      res.last_modified = Detail::http_date(res.mtime);
+
+      return res;
     }
 
-    void on_shutdown(error_code ec_)
+    // set the content encoding headers of a static file response
+    template<typename Res>
+    void encoding_headers(Res& res_, std::string_view encoding_)
     {
-      if (ec_)
+      if (! _attr->http_precompressed)
       {
-        // TODO log here
         return;
       }
-    }
-
-  private:
 
-    websocket::stream<Detail::ssl_stream<tcp::socket>> _socket;
-  }; // class Websockets
-#endif // OB_BELLE_CONFIG_SSL_ON
+      if (! encoding_.empty())
+      {
+        res_.set(Header::content_encoding, beast::string_view {encoding_.data(), encoding_.size()});
+      }
 
-  template<typename Derived, typename Websocket_Type>
-  class Http_Base
-  {
-    Derived& derived()
-    {
-      return static_cast<Derived&>(*this);
+      res_.set(Header::vary, "Accept-Encoding");
     }
 
-  public:
-
-    Http_Base(net::io_context& io_, std::shared_ptr<Attr> const attr_) :
-      _strand {io_.get_executor()},
-      _timer {io_, (std::chrono::steady_clock::time_point::max)()},
-      _attr {attr_}
+    // resolve the request target to a file path in the public directory
+    // uses the path cache if enabled
+    std::shared_ptr<std::string const> static_path()
     {
-    }
+      auto const target = std::string_view(_ctx.req.target().data(), _ctx.req.target().size());
 
-    ~Http_Base()
-    {
-    }
+      auto const resolve = [&]() -> std::shared_ptr<std::string const>
+      {
+        std::string path;
 
-// TODO remove shim once visual studio supports generic lambdas
-#ifdef _MSC_VER
-    template<typename Self, typename Res>
-    static void constexpr send(Self self, Res&& res)
-#else
-    // generic lambda for sending different types of responses
-    static auto constexpr send = [](auto self, auto&& res) -> void
-#endif // _MSC_VER
-    {
-      using item_type = std::remove_reference_t<decltype(res)>;
+        if (! Detail::path_resolve(target, &path))
+        {
+          return {};
+        }
 
-      auto ptr = std::make_shared<item_type>(std::move(res));
-      self->_res = ptr;
+        if (path.back() == '/')
+        {
+          path += _attr->index_file;
+        }
 
-      http::async_write(self->derived().socket(), *ptr,
-        net::bind_executor(self->_strand,
-          [self, close = ptr->need_eof()]
-          (error_code ec, std::size_t bytes)
-          {
-            self->on_write(ec, bytes, close);
-          }
-        )
-      );
-    };
+        return std::make_shared<std::string const>(_attr->public_dir + path);
+      };
 
-    int serve_static()
-    {
-      if (! _attr->http_static || _attr->public_dir.empty())
+      if (! _attr->http_path_cache.capacity())
       {
-        return 404;
+        return resolve();
       }
 
-      if ((_ctx.req.method() != http::verb::get) && (_ctx.req.method() != http::verb::head))
+      auto const path = target.substr(0, target.find_first_of("?#"));
+      auto const key = Detail::hash(path);
+
+      if (auto const entry = _attr->http_path_cache.find(key); entry && (*entry)->target == path)
       {
-        return 404;
+        return {*entry, &(*entry)->path};
       }
 
-      std::string path {_attr->public_dir + _ctx.req.target().to_string()};
+      auto res = resolve();
 
-      if (path.back() == '/')
+      if (! res)
       {
-        path += _attr->index_file;
+        return {};
       }
 
-      error_code ec;
-      http::file_body::value_type body;
-      body.open(path.data(), beast::file_mode::scan, ec);
+      auto entry = std::make_shared<Http_Path_Cache_Entry const>(
+        Http_Path_Cache_Entry {std::string(path), *res});
+      _attr->http_path_cache.insert(key, entry);
 
-      if (ec)
+      return {entry, &entry->path};
+    }
+
+    // open a static file, using the open file cache if enabled
+    // the result is not open if the file is missing or not a regular file
+    std::shared_ptr<Detail::Open_File const> static_open(std::string const& path_)
+    {
+      if (! _attr->http_fd_cache.capacity())
       {
-        return 404;
+        return std::make_shared<Detail::Open_File const>(path_);
       }
 
-      // head request
-      if (_ctx.req.method() == http::verb::head)
+      auto const now = std::chrono::steady_clock::now();
+
+      if (auto const entry = _attr->http_fd_cache.find(path_))
       {
-        http::response<http::empty_body> res {};
-        res.base() = http::response_header<>(_attr->http_headers);
-        res.version(_ctx.req.version());
-        res.keep_alive(_ctx.req.keep_alive());
-        res.content_length(body.size());
-        res.set(Header::content_type, mime_type(path));
-        send(derived().shared_from_this(), std::move(res));
-        return 0;
+        if (now < entry->expires)
+        {
+          return entry->file;
+        }
       }
 
-      // get request
-      auto const size = body.size();
-      http::response<http::file_body> res {
-        std::piecewise_construct,
-        std::make_tuple(std::move(body)),
-        std::make_tuple(_attr->http_headers)
-      };
-      res.version(_ctx.req.version());
-      res.keep_alive(_ctx.req.keep_alive());
-      res.content_length(size);
-      res.set(Header::content_type, mime_type(path));
-      send(derived().shared_from_this(), std::move(res));
-      return 0;
+      auto res = std::make_shared<Detail::Open_File const>(path_);
+      _attr->http_fd_cache.insert(path_, Http_Fd {res, now + _attr->http_fd_cache_ttl});
+
+      return res;
     }
 
-    int serve_dynamic()
+    // find a static file in the cache, loading it if missing or changed
+    // the content type is taken from type_path_
+    // returns nullptr if the file is too large to cache or can not be read
+    std::shared_ptr<Http_File const> static_file(std::string const& path_,
+      std::string const& type_path_, Detail::Open_File const& fd_)
     {
-      if (! _attr->http_dynamic || _attr->http_routes.empty())
+      auto const& st_ = fd_.status();
+      auto const size = fd_.size();
+
+      if (auto const entry = _attr->http_static_cache.find(path_))
       {
-        return 404;
+        if ((*entry)->size == size && (*entry)->mtime == st_.st_mtime)
+        {
+          return *entry;
+        }
       }
 
-      // regex variables
-      std::smatch rx_match {};
-      std::regex_constants::syntax_option_type const rx_opts {std::regex::ECMAScript};
-      std::regex_constants::match_flag_type const rx_flgs {std::regex_constants::match_not_null};
-
-      // the request path
-      std::string path {_ctx.req.target().to_string()};
+      if (size > _attr->http_static_cache_max)
+      {
+        return {};
+      }
 
-      // separate the query parameters
-      auto params = Detail::split(path, "?", 1);
-      path = params.at(0);
+      error_code ec;
+      std::string body;
+      body.resize(static_cast<std::size_t>(size));
 
-      // iterate over routes
-      for (auto const& regex_method : _attr->http_routes)
+      for (std::size_t pos = 0; pos < body.size();)
       {
-        bool method_match {false};
-        auto match = (*regex_method).second.find(0);
+        auto const bytes = fd_.read(pos, &body[pos], body.size() - pos, ec);
 
-        if (match != (*regex_method).second.end())
+        if (ec || bytes == 0)
         {
-          method_match = true;
+          return {};
         }
-        else
+
+        pos += bytes;
+      }
+
+      auto res = std::make_shared<Http_File>(static_info(type_path_, st_));
+      res->body = std::make_shared<std::string const>(std::move(body));
+
+      _attr->http_static_cache.insert(path_, res, static_cast<std::size_t>(size));
+
+      return res;
+    }
+
+    // run a user function that returns false if it did not handle the request
+    // returns 0 on success, 404 if not handled, or the error status
+    template<typename Fn>
+    int serve_handler(Fn const& fn_)
+    {
+      try
+      {
+        // run user function
+        if (! fn_())
         {
-          match = (*regex_method).second.find(static_cast<int>(_ctx.req.method()));
+          return 404;
+        }
 
-          if (match != (*regex_method).second.end())
-          {
-            method_match = true;
-          }
+        _ctx.res.content_length(_ctx.res.body().size());
+        send(derived().shared_from_this(), std::move(_ctx.res));
+        return 0;
+      }
+      catch (int const e)
+      {
+        return e;
+      }
+      catch (unsigned int const e)
+      {
+        return static_cast<int>(e);
+      }
+      catch (Status const e)
+      {
+        return static_cast<int>(e);
+      }
+      catch (std::exception const&)
+      {
+        return 500;
+      }
+      catch (...)
+      {
+        return 500;
+      }
+    }
+
+    // find the first registered route matching the path and method
+    // uses the route cache if enabled
+    bool find_route(std::string_view path_, Method method_,
+      Detail::Router<Http_Route const*>::Match& match_)
+    {
+      auto const pred = [method_](Http_Route const* route)
+      {
+        return route->allowed(method_);
+      };
+
+      if (! _attr->http_route_cache.capacity())
+      {
+        if (_attr->http_router.find(path_, pred, match_))
+        {
+          return true;
         }
 
-        if (method_match)
+        // collect the methods allowed on the path
+        for (auto const& e : match_.rejected)
         {
-          std::regex rx_str {(*regex_method).first, rx_opts};
-          if (std::regex_match(path, rx_match, rx_str, rx_flgs))
-          {
-            // set the path
-            for (auto const& e : rx_match)
-            {
-              _ctx.req.path().emplace_back(e.str());
-            }
+          _allow |= e->methods;
+        }
 
-            // parse target params
-            _ctx.req.params_parse();
+        return false;
+      }
 
-            // set callback function
-            auto const& user_func = match->second;
+      auto const key = Detail::hash(path_) ^
+        (static_cast<std::uint64_t>(method_) * 0x9e3779b97f4a7c15);
+      auto entry = _attr->http_route_cache.find(key);
 
-            try
-            {
-              // run user function
-              user_func(_ctx);
+      if (! entry || (*entry)->method != method_ || (*entry)->path != path_)
+      {
+        auto res = std::make_shared<Http_Route_Cache_Entry>();
+        res->method = method_;
+        res->path = std::string(path_);
 
-              _ctx.res.content_length(_ctx.res.body().size());
-              send(derived().shared_from_this(), std::move(_ctx.res));
-              return 0;
-            }
-            catch (int const e)
-            {
-              return e;
-            }
-            catch (unsigned int const e)
-            {
-              return static_cast<int>(e);
-            }
-            catch (Status const e)
-            {
-              return static_cast<int>(e);
-            }
-            catch (std::exception const&)
+        if (_attr->http_router.find(path_, pred, match_))
+        {
+          res->route = match_.value;
+
+          for (auto const& e : match_.captures)
+          {
+            if (e.empty())
             {
-              return 500;
+              res->captures.emplace_back(0, 0);
             }
-            catch (...)
+            else
             {
-              return 500;
+              res->captures.emplace_back(
+                static_cast<std::size_t>(e.data() - path_.data()), e.size());
             }
           }
         }
+        else
+        {
+          for (auto const& e : match_.rejected)
+          {
+            res->allow |= e->methods;
+          }
+        }
+
+        entry = res;
+        _attr->http_route_cache.insert(key, std::move(res));
+      }
+
+      auto const& e = **entry;
+
+      if (! e.route)
+      {
+        // collect the methods allowed on the path
+        _allow |= e.allow;
+
+        return false;
+      }
+
+      match_.value = e.route;
+      match_.captures.clear();
+
+      for (auto const& [pos, len] : e.captures)
+      {
+        match_.captures.emplace_back(path_.substr(pos, len));
+      }
+
+      return true;
+    }
+
+    int serve_dynamic()
+    {
+      if (! _attr->http_dynamic)
+      {
+        return 404;
+      }
+
+      // the request path without the query parameters
+      std::string_view path {_ctx.req.target().data(), _ctx.req.target().size()};
+      path = path.substr(0, path.find('?'));
+
+      auto const method = _ctx.req.method();
+
+      // check the compile time route table
+      // the table only returns false if no fixed route matched,
+      // once a fixed route handler ran its status ends dispatch,
+      // even if it threw 404
+      if (_attr->http_table)
+      {
+        bool matched {true};
+
+        auto const res = serve_handler(
+          [&]()
+          {
+            matched = _attr->http_table(_ctx, path, method);
+            return matched;
+          }
+        );
+
+        if (matched)
+        {
+          return res;
+        }
+      }
+
+      if (_attr->http_router.empty())
+      {
+        return 404;
+      }
+
+      // find the first registered route matching the path and method
+      Detail::Router<Http_Route const*>::Match match {};
+
+      if (! this->find_route(path, method, match))
+      {
+        return 404;
       }
 
-      return 404;
+      // set the path
+      _ctx.req.path_view() = std::move(match.captures);
+
+      // parse target params on first access
+      _ctx.req.params_defer();
+
+      // set callback function
+      auto const& user_func = *match.value->get(method);
+
+      return serve_handler(
+        [&]()
+        {
+          // run user function
+          user_func(_ctx);
+
+          return true;
+        }
+      );
     }
 
     void serve_error(int err)
@@ -1797,6 +5518,13 @@ private:
 
       // serve static content
       auto stat = this->serve_static();
+      if (stat == 404 && _allow)
+      {
+        // route exists with a different method
+        _ctx.res.set(Header::allow, allow_string(_allow));
+        this->serve_error(405);
+        return;
+      }
       if (stat != 0)
       {
         this->serve_error(stat);
@@ -1804,39 +5532,56 @@ private:
       }
     }
 
-    bool handle_websocket()
+    // join the methods in a bitmask for the allow header
+    static std::string allow_string(std::uint64_t methods_)
     {
-      // the request path
-      std::string path {_ctx.req.target().to_string()};
+      std::string res;
+
+      for (std::size_t i = 1; i < Http_Route::methods_size; ++i)
+      {
+        if (methods_ & (std::uint64_t {1} << i))
+        {
+          if (! res.empty())
+          {
+            res += ", ";
+          }
+
+          res += http::to_string(static_cast<Method>(i)).to_string();
+        }
+      }
+
+      return res;
+    }
 
-      // separate the query parameters
-      auto params = Detail::split(path, "?", 1);
-      path = params.at(0);
+    bool handle_websocket()
+    {
+      // the request path without the query parameters
+      std::string_view path {_ctx.req.target().data(), _ctx.req.target().size()};
+      path = path.substr(0, path.find('?'));
 
       // regex variables
-      std::smatch rx_match {};
-      std::regex_constants::syntax_option_type const rx_opts {std::regex::ECMAScript};
+      std::cmatch rx_match {};
       std::regex_constants::match_flag_type const rx_flgs {std::regex_constants::match_not_null};
 
       // check for matching route
-      for (auto const& [regex, callback] : _attr->websocket_routes)
+      for (auto const& [regex, route] : _attr->websocket_routes)
       {
-        std::regex rx_str {regex, rx_opts};
-
-        if (std::regex_match(path, rx_match, rx_str, rx_flgs))
+        if (std::regex_match(path.data(), path.data() + path.size(),
+          rx_match, route.rx, rx_flgs))
         {
           // set the path
           for (auto const& e : rx_match)
           {
-            _ctx.req.path().emplace_back(e.str());
+            _ctx.req.path_view().emplace_back(e.first,
+              static_cast<std::size_t>(e.length()));
           }
 
-          // parse target params
-          _ctx.req.params_parse();
+          // parse target params on first access
+          _ctx.req.params_defer();
 
           // create websocket
           std::make_shared<Websocket_Type>
-            (derived().socket_move(), _attr, std::move(_ctx.req), callback)
+            (derived().socket_move(), _attr, std::move(_ctx.req), route.fns)
             ->run();
 
           return true;
@@ -1893,6 +5638,7 @@ private:
 
       _res = nullptr;
       _ctx = {};
+      _allow = 0;
       _ctx.res.base() = http::response_header<>(_attr->http_headers);
 
       http::async_read(derived().socket(), _buf, _ctx.req,
@@ -2003,12 +5749,16 @@ private:
       this->do_read();
     }
 
+    // most ranges accepted in a range request
+    static constexpr std::size_t ranges_max {16};
+
     net::strand<net::io_context::executor_type> _strand;
     net::steady_timer _timer;
     boost::beast::flat_buffer _buf;
     std::shared_ptr<Attr> const _attr;
     Http_Ctx _ctx {};
     std::shared_ptr<void> _res {nullptr};
+    std::uint64_t _allow {0};
     bool _close {false};
   }; // class Http_Base
 
@@ -2040,8 +5790,14 @@ private:
 
     void run()
     {
-      this->do_timer();
-      this->do_read();
+      // start on the strand, the timer handler runs on it
+      net::dispatch(this->_strand,
+        [self = this->shared_from_this()]()
+        {
+          self->do_timer();
+          self->do_read();
+        }
+      );
     }
 
     void do_timeout()
@@ -2065,8 +5821,118 @@ private:
       }
     }
 
+#ifdef __linux__
+    // send the header with a serializer, then the body with sendfile
+    void send_file(http::response<Detail::File_Body<>>&& res_)
+    {
+      if (! this->_attr->http_sendfile)
+      {
+        Http_Base<Http, Websocket>::send_file(std::move(res_));
+        return;
+      }
+
+      auto op = std::make_shared<Sendfile_Op>(std::move(res_));
+      op->size = op->res.body()->size();
+      op->close = op->res.need_eof();
+      this->_res = op;
+
+      http::async_write_header(_socket, op->sr,
+        net::bind_executor(this->_strand,
+          [self = this->shared_from_this(), op](error_code ec, std::size_t bytes)
+          {
+            boost::ignore_unused(bytes);
+
+            if (ec)
+            {
+              self->on_write(ec, 0, op->close);
+              return;
+            }
+
+            self->do_sendfile(op);
+          }
+        )
+      );
+    }
+#endif // __linux__
+
   private:
 
+#ifdef __linux__
+    struct Sendfile_Op
+    {
+      Sendfile_Op(http::response<Detail::File_Body<>>&& res_) :
+        res {std::move(res_)}
+      {
+      }
+
+      http::response<Detail::File_Body<>> res;
+      http::response_serializer<Detail::File_Body<>> sr {res};
+      std::uint64_t size {0};
+      off_t offset {0};
+      bool close {false};
+    }; // struct Sendfile_Op
+
+    // write the file until done or the socket would block
+    void do_sendfile(std::shared_ptr<Sendfile_Op> op_)
+    {
+      error_code ec;
+      _socket.native_non_blocking(true, ec);
+
+      while (! ec && static_cast<std::uint64_t>(op_->offset) < op_->size)
+      {
+        auto const left = op_->size - static_cast<std::uint64_t>(op_->offset);
+        auto const n = ::sendfile(_socket.native_handle(),
+          op_->res.body()->native_handle(), &op_->offset,
+          static_cast<std::size_t>(std::min<std::uint64_t>(left, 1 << 30)));
+
+        if (n > 0)
+        {
+          continue;
+        }
+
+        if (n == 0)
+        {
+          // the file was truncated
+          ec = net::error::eof;
+        }
+        else if (errno == EINTR)
+        {
+          continue;
+        }
+        else if (errno == EAGAIN
+#if EAGAIN != EWOULDBLOCK
+          || errno == EWOULDBLOCK
+#endif // EAGAIN != EWOULDBLOCK
+          )
+        {
+          // wait until the socket is writable
+          _socket.async_wait(tcp::socket::wait_write,
+            net::bind_executor(this->_strand,
+              [self = this->shared_from_this(), op_](error_code ec_)
+              {
+                if (ec_)
+                {
+                  self->on_write(ec_, 0, op_->close);
+                  return;
+                }
+
+                self->do_sendfile(op_);
+              }
+            )
+          );
+
+          return;
+        }
+        else
+        {
+          ec.assign(errno, boost::system::system_category());
+        }
+      }
+
+      this->on_write(ec, static_cast<std::size_t>(op_->offset), op_->close);
+    }
+#endif // __linux__
+
     tcp::socket _socket;
   }; // class Http
 
@@ -2100,8 +5966,14 @@ private:
 
     void run()
     {
-      this->do_timer();
-      this->do_handshake();
+      // start on the strand, the timer handler runs on it
+      net::dispatch(this->_strand,
+        [self = this->shared_from_this()]()
+        {
+          self->do_timer();
+          self->do_handshake();
+        }
+      );
     }
 
     void do_timeout()
@@ -2197,7 +6069,8 @@ private:
   {
   public:
 
-    Listener(net::io_context& io_, tcp::endpoint endpoint_, std::shared_ptr<Attr> const attr_) :
+    Listener(net::io_context& io_, tcp::endpoint endpoint_, std::shared_ptr<Attr> const attr_,
+      bool reuse_port_ = false) :
       _acceptor {io_},
       _socket {io_},
       _attr {attr_}
@@ -2220,6 +6093,26 @@ private:
         return;
       }
 
+#ifdef SO_REUSEPORT
+      // allow multiple listeners on the same port
+      if (reuse_port_)
+      {
+        int const val {1};
+
+        if (::setsockopt(_acceptor.native_handle(), SOL_SOCKET, SO_REUSEPORT,
+          &val, sizeof(val)) != 0)
+        {
+          ec.assign(errno, boost::system::system_category());
+        }
+
+        if (ec)
+        {
+          // TODO log here
+          return;
+        }
+      }
+#endif // SO_REUSEPORT
+
       // bind to the server address
       _acceptor.bind(endpoint_, ec);
       if (ec)
@@ -2400,6 +6293,27 @@ public:
     return _threads;
   }
 
+  // set io context per thread
+  // each thread runs its own io context with its own listener,
+  // bound to the same address and port with SO_REUSEPORT,
+  // the kernel balances new connections across the listeners
+  // and a connection stays on the thread that accepted it
+  // the other io contexts are stopped when the io context returned by io() stops
+  // requires SO_REUSEPORT, otherwise the threads share one io context
+  // default value is false
+  Server& io_per_thread(bool io_per_thread_)
+  {
+    _io_per_thread = io_per_thread_;
+
+    return *this;
+  }
+
+  // get io context per thread
+  bool io_per_thread()
+  {
+    return _io_per_thread;
+  }
+
 #ifdef OB_BELLE_CONFIG_SSL_ON
   // set ssl
   Server& ssl(bool ssl_)
@@ -2458,6 +6372,172 @@ public:
     return _attr->http_dynamic;
   }
 
+  // set the open file cache capacity, the most files held open
+  // keeps the descriptor and status of recently served static files,
+  // shared by concurrent responses, and remembers missing files
+  // a file stays open while a response is using it, even if evicted
+  // default value is 0, disabled
+  Server& http_fd_cache(std::size_t capacity_)
+  {
+    _attr->http_fd_cache.capacity(capacity_);
+
+    return *this;
+  }
+
+  // get the open file cache capacity
+  std::size_t http_fd_cache()
+  {
+    return _attr->http_fd_cache.capacity();
+  }
+
+  // set how long an open file cache entry is used before the file is reopened
+  // changes to a file may not be seen until its entry expires
+  // default value is 10 seconds
+  Server& http_fd_cache_ttl(std::chrono::seconds ttl_)
+  {
+    _attr->http_fd_cache_ttl = ttl_;
+
+    return *this;
+  }
+
+  // get the open file cache entry lifetime
+  std::chrono::seconds http_fd_cache_ttl()
+  {
+    return _attr->http_fd_cache_ttl;
+  }
+
+  // get the open file cache counters
+  Cache_Stats http_fd_cache_stats()
+  {
+    return _attr->http_fd_cache.stats();
+  }
+
+  // set the number of threads reading static files
+  // file blocks are read on a separate thread pool and written on the
+  // connection, so a slow disk read does not block other connections
+  // sendfile and memory mapped files are not read by the pool,
+  // disable them to move all static file reads off the io threads
+  // default value is 0, files are read on the io threads
+  Server& http_file_threads(std::size_t threads_)
+  {
+    _attr->http_file_threads = threads_;
+
+    return *this;
+  }
+
+  // get the number of threads reading static files
+  std::size_t http_file_threads()
+  {
+    return _attr->http_file_threads;
+  }
+
+  // set http mmap
+  // send static files from a read only memory mapping shared by
+  // concurrent responses, without a read buffer per connection
+  // used when sendfile is not, such as on https connections
+  // a file truncated while mapped can raise SIGBUS,
+  // replace files instead of modifying them in place
+  // default value is false
+  Server& http_mmap(bool val_)
+  {
+    _attr->http_mmap = val_;
+
+    return *this;
+  }
+
+  // get http mmap
+  bool http_mmap()
+  {
+    return _attr->http_mmap;
+  }
+
+  // set the largest file size in bytes sent from a memory mapping
+  // larger files are read into a buffer per connection
+  // default value is 1GB
+  Server& http_mmap_max(std::uint64_t size_)
+  {
+    _attr->http_mmap_max = size_;
+
+    return *this;
+  }
+
+  // get the largest file size in bytes sent from a memory mapping
+  std::uint64_t http_mmap_max()
+  {
+    return _attr->http_mmap_max;
+  }
+
+  // set http static watch
+  // watch the public directory with inotify while listening,
+  // removing changed files from the open file and static file caches
+  // changes are seen immediately, so the open file cache ttl can be raised
+  // only available on linux, ignored elsewhere
+  // default value is false
+  Server& http_static_watch(bool val_)
+  {
+    _attr->http_static_watch = val_;
+
+    return *this;
+  }
+
+  // get http static watch
+  bool http_static_watch()
+  {
+    return _attr->http_static_watch;
+  }
+
+  // set the cache control header sent with static files
+  // static responses carry an etag and last-modified date,
+  // and a matching conditional request is answered with 304 not modified
+  // default value is empty, the default http headers are used
+  Server& http_static_cache_control(std::string const& val_)
+  {
+    _attr->http_static_cache_control = val_;
+
+    return *this;
+  }
+
+  // get the cache control header sent with static files
+  std::string http_static_cache_control()
+  {
+    return _attr->http_static_cache_control;
+  }
+
+  // set http precompressed
+  // serve a '.br', '.zst', or '.gz' sibling of a static file
+  // when the client accepts its encoding
+  // default value is false
+  Server& http_precompressed(bool val_)
+  {
+    _attr->http_precompressed = val_;
+
+    return *this;
+  }
+
+  // get http precompressed
+  bool http_precompressed()
+  {
+    return _attr->http_precompressed;
+  }
+
+  // set http sendfile
+  // send static file bodies from the kernel with sendfile on
+  // plain http connections, avoiding a copy through user space
+  // only available on linux, ignored elsewhere
+  // default value is true
+  Server& http_sendfile(bool val_)
+  {
+    _attr->http_sendfile = val_;
+
+    return *this;
+  }
+
+  // get http sendfile
+  bool http_sendfile()
+  {
+    return _attr->http_sendfile;
+  }
+
   // set http static and dynamic
   Server& http(bool val_)
   {
@@ -2529,18 +6609,18 @@ public:
   }
 
   // set http callback matching a single method
+  // the route is either a literal path, a path with ':param' segments,
+  // or a regex, matched in the order they were first registered
   // called after http read
   Server& on_http(std::string route_, Method method_, fn_on_http on_http_)
   {
     if (_attr->http_routes.find(route_) == _attr->http_routes.map_end())
     {
-      _attr->http_routes(route_, {{static_cast<int>(method_), on_http_}});
-    }
-    else
-    {
-      _attr->http_routes.at(route_)[static_cast<int>(method_)] = on_http_;
+      _attr->http_routes(route_, Http_Route(route_));
     }
 
+    _attr->http_routes.at(route_).set(method_, on_http_);
+
     return *this;
   }
 
@@ -2548,16 +6628,14 @@ public:
   // called after http read
   Server& on_http(std::string route_, std::vector<Method> methods_, fn_on_http on_http_)
   {
+    if (_attr->http_routes.find(route_) == _attr->http_routes.map_end())
+    {
+      _attr->http_routes(route_, Http_Route(route_));
+    }
+
     for (auto const& e : methods_)
     {
-      if (_attr->http_routes.find(route_) == _attr->http_routes.map_end())
-      {
-        _attr->http_routes(route_, {{static_cast<int>(e), on_http_}});
-      }
-      else
-      {
-        _attr->http_routes.at(route_)[static_cast<int>(e)] = on_http_;
-      }
+      _attr->http_routes.at(route_).set(e, on_http_);
     }
 
     return *this;
@@ -2569,13 +6647,34 @@ public:
   {
     if (_attr->http_routes.find(route_) == _attr->http_routes.map_end())
     {
-      _attr->http_routes(route_, {{0, on_http_}});
+      _attr->http_routes(route_, Http_Route(route_));
     }
-    else
+
+    _attr->http_routes.at(route_).set(Method::unknown, on_http_);
+
+    return *this;
+  }
+
+  // add a compile time table of fixed http routes
+  // checked before the other http routes
+  // multiple tables are merged, checked in the order they were added
+  // called after http read
+  template<typename... Routes>
+  Server& on_http(Http_Route_Table<Routes...> table_)
+  {
+    if (! _attr->http_table)
     {
-      _attr->http_routes.at(route_)[0] = on_http_;
+      _attr->http_table = std::move(table_);
+
+      return *this;
     }
 
+    _attr->http_table = [prev = std::move(_attr->http_table), table = std::move(table_)]
+      (Http_Ctx& ctx_, std::string_view path_, Method method_)
+      {
+        return prev(ctx_, path_, method_) || table(ctx_, path_, method_);
+      };
+
     return *this;
   }
 
@@ -2610,8 +6709,8 @@ public:
   // data: called after every websocket read
   Server& on_websocket(std::string route_, fn_on_websocket data_)
   {
-    _attr->websocket_routes.emplace_back(
-      std::make_pair(route_, fns_on_websocket(nullptr, data_, nullptr)));
+    _attr->websocket_routes.emplace_back(route_,
+      Websocket_Route(route_, fns_on_websocket(nullptr, data_, nullptr)));
 
     return *this;
   }
@@ -2623,8 +6722,8 @@ public:
   Server& on_websocket(std::string route_,
     fn_on_websocket begin_, fn_on_websocket data_, fn_on_websocket end_)
   {
-    _attr->websocket_routes.emplace_back(
-      std::make_pair(route_, fns_on_websocket(begin_, data_, end_)));
+    _attr->websocket_routes.emplace_back(route_,
+      Websocket_Route(route_, fns_on_websocket(begin_, data_, end_)));
 
     return *this;
   }
@@ -2656,6 +6755,90 @@ public:
     return *this;
   }
 
+  // set the http route cache capacity
+  // caches the matched route for each method and path
+  // default value is 0, disabled
+  Server& http_route_cache(std::size_t capacity_)
+  {
+    _attr->http_route_cache.capacity(capacity_);
+
+    return *this;
+  }
+
+  // get the http route cache capacity
+  std::size_t http_route_cache()
+  {
+    return _attr->http_route_cache.capacity();
+  }
+
+  // get the http route cache counters
+  Cache_Stats http_route_cache_stats()
+  {
+    return _attr->http_route_cache.stats();
+  }
+
+  // set the static path cache capacity
+  // caches the file path resolved from each request target
+  // default value is 0, disabled
+  Server& http_path_cache(std::size_t capacity_)
+  {
+    _attr->http_path_cache.capacity(capacity_);
+
+    return *this;
+  }
+
+  // get the static path cache capacity
+  std::size_t http_path_cache()
+  {
+    return _attr->http_path_cache.capacity();
+  }
+
+  // get the static path cache counters
+  Cache_Stats http_path_cache_stats()
+  {
+    return _attr->http_path_cache.stats();
+  }
+
+  // set the static file cache capacity in bytes
+  // caches the contents and headers of files served from the public directory
+  // a cached file is reloaded when its size or modification time changes
+  // default value is 0, disabled
+  Server& http_static_cache(std::size_t capacity_)
+  {
+    _attr->http_static_cache.capacity(capacity_, _attr->http_static_cache_max);
+
+    return *this;
+  }
+
+  // get the static file cache capacity in bytes
+  std::size_t http_static_cache()
+  {
+    return _attr->http_static_cache.capacity();
+  }
+
+  // set the largest file size in bytes stored in the static file cache
+  // larger files are read from disk on each request
+  // default value is 1MB
+  Server& http_static_cache_max(std::size_t size_)
+  {
+    _attr->http_static_cache_max = size_;
+    _attr->http_static_cache.capacity(_attr->http_static_cache.capacity(), size_);
+
+    return *this;
+  }
+
+  // get the largest file size in bytes stored in the static file cache
+  std::size_t http_static_cache_max()
+  {
+    return _attr->http_static_cache_max;
+  }
+
+  // get the static file cache counters
+  Cache_Stats http_static_cache_stats()
+  {
+    return _attr->http_static_cache.stats();
+  }
+
   // get http routes
   Http_Routes& http_routes()
   {
@@ -2759,30 +6942,77 @@ public:
       _attr->http_headers.set(Header::server, "Belle");
     }
 
-    // websocket channels are not threadsafe, limit to 1 thread
-    if (_attr->websocket && _threads > 1)
+    // build the http router from the registered http routes
+    _attr->http_router.clear();
+    _attr->http_route_cache.clear();
+    _attr->http_path_cache.clear();
+
+    for (auto const& e : _attr->http_routes)
     {
-      _threads = 1;
+      _attr->http_router.add((*e).first, (*e).second.rx, &(*e).second);
     }
 
-    // create the listener
-#ifdef OB_BELLE_CONFIG_SSL_ON
-    if (_attr->ssl)
+#ifdef __linux__
+    // watch the public directory for changes
+    if (_attr->http_static_watch && ! _attr->public_dir.empty())
     {
-      // use https
-      std::make_shared<Listener<Https>>
-        (_io, tcp::endpoint(net::ip::make_address(_address), _port), _attr)
-        ->run();
+      _watch.watch(_attr->public_dir,
+        [attr = _attr](std::string const& path)
+        {
+          if (path.empty())
+          {
+            attr->http_fd_cache.clear();
+            attr->http_static_cache.clear();
+            return;
+          }
+
+          attr->http_fd_cache.erase(path);
+          attr->http_static_cache.erase(path);
+        }
+      );
     }
-    else
-#endif // OB_BELLE_CONFIG_SSL_ON
+#endif // __linux__
+
+    // start the static file read thread pool
+    if (_attr->http_file_threads > 0)
     {
-      // use http
-      std::make_shared<Listener<Http>>
-        (_io, tcp::endpoint(net::ip::make_address(_address), _port), _attr)
-        ->run();
+      _attr->file_pool = std::make_unique<net::thread_pool>(_attr->http_file_threads);
     }
 
+#ifndef SO_REUSEPORT
+    // each thread needs its own listener on the same port
+    _io_per_thread = false;
+#endif // SO_REUSEPORT
+
+    auto const reuse_port = _io_per_thread && _threads > 1;
+
+    // create a listener on an io context
+    auto const listener = [&](net::io_context& io)
+    {
+#ifdef OB_BELLE_CONFIG_SSL_ON
+      if (_attr->ssl)
+      {
+        // use https
+        std::make_shared<Listener<Https>>
+          (io, tcp::endpoint(net::ip::make_address(_address), _port), _attr, reuse_port)
+          ->run();
+      }
+      else
+#endif // OB_BELLE_CONFIG_SSL_ON
+      {
+        // use http
+        std::make_shared<Listener<Http>>
+          (io, tcp::endpoint(net::ip::make_address(_address), _port), _attr, reuse_port)
+          ->run();
+      }
+    };
+
+    // create the listener
+    listener(_io);
+
+    // io contexts owned by each thread if enabled
+    std::vector<std::unique_ptr<net::io_context>> io_contexts;
+
     // thread pool
     std::vector<std::thread> io_threads;
 
@@ -2793,6 +7023,22 @@ public:
 
       for (unsigned int i = 1; i < _threads; ++i)
       {
+        if (reuse_port)
+        {
+          // run a listener on the io context of the new thread
+          auto& io = *io_contexts.emplace_back(std::make_unique<net::io_context>(1));
+          listener(io);
+
+          io_threads.emplace_back(
+            [&io]()
+            {
+              io.run();
+            }
+          );
+
+          continue;
+        }
+
         io_threads.emplace_back(
           [this]()
           {
@@ -2806,11 +7052,24 @@ public:
     // run the io context on the current thread
     _io.run();
 
+    // stop the io contexts owned by each thread
+    for (auto& e : io_contexts)
+    {
+      e->stop();
+    }
+
     // wait on threads to return
     for (auto& t : io_threads)
     {
       t.join();
     }
+
+    // wait on the static file read thread pool
+    if (_attr->file_pool)
+    {
+      _attr->file_pool->join();
+      _attr->file_pool.reset();
+    }
   }
 
 private:
@@ -2827,12 +7086,20 @@ private:
   // the number of threads to run on
   unsigned int _threads {1};
 
+  // run an io context and listener on each thread
+  bool _io_per_thread {false};
+
   // the io context
   net::io_context _io {};
 
   // signals
   net::signal_set _signals {_io};
 
+#ifdef __linux__
+  // public directory watcher
+  Detail::Dir_Watch _watch {_io};
+#endif // __linux__
+
   // callback for signals
   fn_on_signal _on_signal {};
 }; // class Server
@@ -2859,7 +7126,7 @@ public:
   }; // struct Error_Ctx
 
   // callbacks
-  using fn_on_http = std::function<void(Http_Ctx&)>;
+  using fn_on_http = Detail::Function<void(Http_Ctx&)>;
   using fn_on_http_error = std::function<void(Error_Ctx&)>;
 
   struct Req_Ctx